@@ -136,6 +136,9 @@
 /* Define to 1 if you have the `floor' function. */
 #cmakedefine HAVE_FLOOR 1
 
+/* Define to 1 if you have the `fork' function. */
+#cmakedefine HAVE_FORK 1
+
 /* Define to 1 if you have the <ieeefp.h> header file. */
 #cmakedefine HAVE_IEEEFP_H 1
 
@@ -157,6 +160,9 @@
 /* Define to 1 if you have the <memory.h> header file. */
 #cmakedefine HAVE_MEMORY_H 1
 
+/* Define to 1 if you have the `mmap' function. */
+#cmakedefine HAVE_MMAP 1
+
 /* Define to 1 if you have the `modf' function. */
 #cmakedefine HAVE_MODF 1
 
@@ -48,6 +48,7 @@ acsolver::acsolver () : nasolver<nr_complex_t> () {
   setDescription ("AC");
   xn = NULL;
   noise = 0;
+  algo = ALGO_LU_DECOMPOSITION;
 }
 
 // Constructor creates a named instance of the acsolver class.
@@ -57,6 +58,7 @@ acsolver::acsolver (char * n) : nasolver<nr_complex_t> (n) {
   setDescription ("AC");
   xn = NULL;
   noise = 0;
+  algo = ALGO_LU_DECOMPOSITION;
 }
 
 // Destructor deletes the acsolver class object.
@@ -71,6 +73,7 @@ acsolver::acsolver (acsolver & o) : nasolver<nr_complex_t> (o) {
   swp = o.swp ? new sweep (*(o.swp)) : NULL;
   xn = o.xn ? new tvector<nr_double_t> (*(o.xn)) : NULL;
   noise = o.noise;
+  algo = o.algo;
 }
 
 /* This is the AC netlist solver.  It prepares the circuit list for
@@ -86,15 +89,41 @@ int acsolver::solve (void) {
     swp = createSweep ("acfrequency");
   }
 
+  // choose a solver
+  algo = ALGO_LU_DECOMPOSITION;
+  if (!strcmp (getPropertyString ("Solver"), "SparseLU"))
+    algo = ALGO_LU_DECOMPOSITION_SPARSE;
+  eqnAlgo = algo;
+
   // initialize node voltages, first guess for non-linear circuits and
   // generate extra circuits if necessary
   init ();
   setCalculation ((calculate_func_t) &calc);
   solve_pre ();
+  algo = eqnAlgo;
+
+  // solve the frequency points in several processes if requested
+  int err = 0;
+  int points = swp->getSize ();
+  int workers = getPropertyInteger ("Workers");
+  if (workers > 1 && points > 2) {
+    // the first frequency creates the dataset vectors
+    err |= solvePoints (0, 1);
+    err |= solveWorkers (workers, 1, points);
+  }
+  else {
+    err |= solvePoints (0, points);
+  }
+  solve_post ();
+  if (progress) logprogressclear (40);
+  return err;
+}
 
-  swp->reset ();
-  for (int i = 0; i < swp->getSize (); i++) {
-    freq = swp->next ();
+/* The function solves the AC netlist for the given slice of
+   frequencies and saves the results. */
+int acsolver::solvePoints (int from, int to) {
+  for (int i = from; i < to; i++) {
+    freq = swp->get (i);
     if (progress) logprogressbar (i, swp->getSize (), 40);
 
 #if DEBUG && 0
@@ -103,7 +132,7 @@ int acsolver::solve (void) {
 #endif
 
     // start the linear solver
-    eqnAlgo = ALGO_LU_DECOMPOSITION;
+    eqnAlgo = algo;
     solve_linear ();
 
     // compute noise if requested
@@ -112,8 +141,6 @@ int acsolver::solve (void) {
     // save results
     saveAllResults (freq);
   }
-  solve_post ();
-  if (progress) logprogressclear (40);
   return 0;
 }
 
@@ -132,6 +159,7 @@ void acsolver::calc (acsolver * self) {
 void acsolver::init (void) {
   circuit * root = subnet->getRoot ();
   for (circuit * c = root; c != NULL; c = (circuit *) c->getNext ()) {
+    c->setRealMNA (false);
     if (c->isNonLinear ()) c->calcOperatingPoints ();
     c->initAC ();
     if (noise) c->initNoiseAC ();
@@ -202,14 +230,21 @@ void acsolver::solve_noise (void) {
 
   // create the MNA matrix once again and LU decompose the adjoint matrix
   createMatrix ();
-  A->transpose ();
-  eqnAlgo = ALGO_LU_FACTORIZATION_CROUT;
+  if (As != NULL) {
+    As->transpose ();
+    eqnAlgo = ALGO_LU_FACTORIZATION_SPARSE;
+  }
+  else {
+    A->transpose ();
+    eqnAlgo = ALGO_LU_FACTORIZATION_CROUT;
+  }
   runMNA ();
 
   // ensure skipping LU decomposition
   updateMatrix = 0;
   convHelper = CONV_None;
-  eqnAlgo = ALGO_LU_SUBSTITUTION_CROUT;
+  eqnAlgo = As != NULL ? ALGO_LU_SUBSTITUTION_SPARSE :
+    ALGO_LU_SUBSTITUTION_CROUT;
 
   // compute noise voltage for each node (and voltage source)
   for (int i = 0; i < N + M; i++) {
@@ -235,6 +270,9 @@ PROP_OPT [] = {
   { "Stop", PROP_REAL, { 10e9, PROP_NO_STR }, PROP_POS_RANGE },
   { "Points", PROP_INT, { 10, PROP_NO_STR }, PROP_MIN_VAL (2) },
   { "Values", PROP_LIST, { 10, PROP_NO_STR }, PROP_POS_RANGE },
+  { "Solver", PROP_STR, { PROP_NO_VAL, "CroutLU" },
+    PROP_RNG_STR2 ("CroutLU", "SparseLU") },
+  { "Workers", PROP_INT, { 1, PROP_NO_STR }, PROP_MIN_VAL (1) },
   PROP_NO_PROP };
 struct define_t acsolver::anadef =
   { "AC", 0, PROP_ACTION, PROP_NO_SUBSTRATE, PROP_LINEAR, PROP_DEF };
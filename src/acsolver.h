@@ -40,6 +40,7 @@ class acsolver : public nasolver<nr_complex_t>
   acsolver (acsolver &);
   ~acsolver ();
   int  solve (void);
+  int  solvePoints (int, int);
   void solve_noise (void);
   static void calc (acsolver *);
   void init (void);
@@ -50,6 +51,7 @@ class acsolver : public nasolver<nr_complex_t>
   sweep * swp;
   nr_double_t freq;
   int noise;
+  int algo;
   tvector<nr_double_t> * xn;
 };
 
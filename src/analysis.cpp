@@ -34,9 +34,17 @@
 # include <config.h>
 #endif
 
-//#include <stdio.h>
-//#include <stdlib.h>
+#include <stdio.h>
+#include <stdlib.h>
 #include <string.h>
+#include <map>
+#include <vector>
+
+#if HAVE_FORK
+#include <unistd.h>
+#include <sys/types.h>
+#include <sys/wait.h>
+#endif
 
 #include "object.h"
 #include "complex.h"
@@ -45,6 +53,7 @@
 #include "strlist.h"
 #include "dataset.h"
 #include "ptrlist.h"
+#include "logging.h"
 #include "analysis.h"
 
 namespace qucs {
@@ -58,6 +67,8 @@ analysis::analysis () : object () {
   type = ANALYSIS_UNKNOWN;
   runs = 0;
   progress = true;
+  warmStart = false;
+  continuation = NULL;
 }
 
 // Constructor creates a named instance of the analysis class.
@@ -69,6 +80,8 @@ analysis::analysis (const std::string &n) : object (n) {
   type = ANALYSIS_UNKNOWN;
   runs = 0;
   progress = true;
+  warmStart = false;
+  continuation = NULL;
 }
 
 // Destructor deletes the analysis class object.
@@ -86,6 +99,8 @@ analysis::analysis (analysis & a) : object (a) {
   type = a.type;
   runs = a.runs;
   progress = a.progress;
+  warmStart = a.warmStart;
+  continuation = a.continuation;
 }
 
 /* This function adds the given analysis to the actions being
@@ -164,4 +179,162 @@ sweep * analysis::createSweep (const std::string& n) {
   d->add (z);
 }
 
+#if HAVE_FORK
+
+/* Helper functions transferring the results of a sweep worker
+   through a pipe. */
+static void sendString (FILE * f, const char * str) {
+  int len = str ? strlen (str) : -1;
+  fwrite (&len, sizeof (int), 1, f);
+  if (len > 0) fwrite (str, 1, len, f);
+}
+
+static char * recvString (FILE * f) {
+  int len;
+  if (fread (&len, sizeof (int), 1, f) != 1 || len < 0) return NULL;
+  char * str = (char *) calloc (1, len + 1);
+  if (fread (str, 1, len, f) != (size_t) len) {
+    free (str);
+    return NULL;
+  }
+  return str;
+}
+
+/* The function solves the sweep points [from, to) by means of the
+   solvePoints() function in several forked worker processes.  Each
+   worker owns a private copy of the netlist, its matrices and the
+   per-circuit buffers and solves a contiguous slice of points.  The
+   workers send back the values appended to the dataset vectors which
+   are then merged in sweep order, such that the output equals the one
+   of a serial sweep.  The dataset vectors should already exist, i.e.
+   at least one point should have been solved beforehand. */
+int analysis::solveWorkers (int workers, int from, int to) {
+  int err = 0, w;
+  int points = to - from;
+  if (points <= 0) return 0;
+
+  // remember the current sizes of the dataset vectors
+  std::map<vector *, int> sizes;
+  vector * v;
+  for (v = data->getDependencies (); v; v = (vector *) v->getNext ())
+    sizes[v] = v->getSize ();
+  for (v = data->getVariables (); v; v = (vector *) v->getNext ())
+    sizes[v] = v->getSize ();
+
+  // start the workers, each of them solving a slice of sweep points
+  if (workers > points) workers = points;
+  std::vector<pid_t> pid (workers, -1);
+  std::vector<int> fd (workers, -1), first (workers + 1);
+  for (w = 0; w <= workers; w++)
+    first[w] = from + (int) ((long) points * w / workers);
+  fflush (stdout);
+  fflush (stderr);
+  for (w = 0; w < workers; w++) {
+    int p[2];
+    if (pipe (p) != 0) continue;
+    if ((pid[w] = fork ()) == 0) {
+      // the worker process
+      close (p[0]);
+      FILE * f = fdopen (p[1], "wb");
+      progress = false;
+      int e = solvePoints (first[w], first[w + 1]);
+      fwrite (&e, sizeof (int), 1, f);
+      for (int dep = 1; dep >= 0; dep--) {
+	v = dep ? data->getDependencies () : data->getVariables ();
+	for (; v; v = (vector *) v->getNext ()) {
+	  int start = sizes.count (v) ? sizes[v] : 0;
+	  int count = v->getSize () - start;
+	  strlist * deps = v->getDependencies ();
+	  int ndeps = deps ? deps->length () : 0;
+	  fwrite (&dep, sizeof (int), 1, f);
+	  sendString (f, v->getName ());
+	  sendString (f, v->getOrigin ());
+	  fwrite (&ndeps, sizeof (int), 1, f);
+	  for (int d = 0; d < ndeps; d++) sendString (f, deps->get (d));
+	  fwrite (&count, sizeof (int), 1, f);
+	  for (int k = start; k < start + count; k++) {
+	    nr_complex_t z = v->get (k);
+	    nr_double_t re = real (z), im = imag (z);
+	    fwrite (&re, sizeof (nr_double_t), 1, f);
+	    fwrite (&im, sizeof (nr_double_t), 1, f);
+	  }
+	}
+      }
+      fclose (f);
+      fflush (stdout);
+      fflush (stderr);
+      _exit (0);
+    }
+    close (p[1]);
+    if (pid[w] < 0) close (p[0]);
+    else fd[w] = p[0];
+  }
+
+  // collect the results of the workers in sweep order
+  for (w = 0; w < workers; w++) {
+    if (pid[w] < 0) {
+      // could not start the worker, solve its slice here
+      err |= solvePoints (first[w], first[w + 1]);
+      continue;
+    }
+    FILE * f = fdopen (fd[w], "rb");
+    int e = 1, dep;
+    if (fread (&e, sizeof (int), 1, f) != 1) {
+      logprint (LOG_ERROR, "ERROR: %s: sweep worker %d failed\n",
+		getName (), w + 1);
+    }
+    err |= e;
+    while (fread (&dep, sizeof (int), 1, f) == 1) {
+      char * name = recvString (f);
+      char * origin = recvString (f);
+      int ndeps = 0, count = 0;
+      if (fread (&ndeps, sizeof (int), 1, f) != 1) ndeps = 0;
+      strlist * deps = new strlist ();
+      for (int d = 0; d < ndeps; d++) {
+	char * str = recvString (f);
+	if (str) deps->append (str);
+	free (str);
+      }
+      if (fread (&count, sizeof (int), 1, f) != 1) count = 0;
+      // find the vector or create it if the worker did so
+      v = dep ? data->findDependency (name) : data->findVariable (name);
+      if (v == NULL) {
+	v = new vector (name);
+	v->setOrigin (origin);
+	if (dep) data->addDependency (v);
+	else data->addVariable (v);
+      }
+      if (ndeps > 0) {
+	if (v->getDependencies () == NULL) v->setDependencies (new strlist ());
+	for (int d = 0; d < ndeps; d++)
+	  if (!v->getDependencies()->contains (deps->get (d)))
+	    v->getDependencies()->append (deps->get (d));
+      }
+      delete deps;
+      for (int k = 0; k < count; k++) {
+	nr_double_t re = 0, im = 0;
+	if (fread (&re, sizeof (nr_double_t), 1, f) != 1 ||
+	    fread (&im, sizeof (nr_double_t), 1, f) != 1)
+	  break;
+	v->add (nr_complex_t (re, im));
+      }
+      free (name);
+      free (origin);
+    }
+    fclose (f);
+    waitpid (pid[w], NULL, 0);
+    if (progress) logprogressbar (first[w + 1] - 1, to, 40);
+  }
+  return err;
+}
+
+#else /* !HAVE_FORK */
+
+/* Without process support the sweep points are solved serially. */
+int analysis::solveWorkers (int, int from, int to) {
+  return solvePoints (from, to);
+}
+
+#endif /* HAVE_FORK */
+
 } // namespace qucs
@@ -162,9 +162,17 @@ public:
         return data;
     }
 
+    /*! \fn setData
+     * \brief Sets the output dataset
+     * \param d pointer to the dataset the results are saved into
+     *
+     * Sets the output dataset and resets the number of solver runs,
+     * which always count the runs saving into the current dataset.
+     */
     void setData (dataset * d)
     {
         data = d;
+        runs = 0;
     }
 
     net * getNet (void)
@@ -246,6 +254,32 @@ public:
      */
     void saveVariable (const std::string &, nr_complex_t, qucs::vector *);
 
+    /*! \fn solvePoints
+     * \brief solves a slice of sweep points
+     * \param from index of the first sweep point
+     * \param to index behind the last sweep point
+     *
+     * Virtual function intended to be overridden by analyses which
+     * support parallel sweeps.  It solves the given sweep points in
+     * order and saves the results into the dataset.
+     */
+    virtual int solvePoints (int, int)
+    {
+        return 0;
+    }
+
+    /*! \fn solveWorkers
+     * \brief solves sweep points in several worker processes
+     * \param workers number of worker processes
+     * \param from index of the first sweep point
+     * \param to index behind the last sweep point
+     *
+     * Splits the given sweep points into slices solved by
+     * solvePoints() in forked worker processes and merges the
+     * results into the dataset in sweep order.
+     */
+    int solveWorkers (int, int, int);
+
     /*! \fn getProgress
      * \brief get
      * \param progress
@@ -267,6 +301,79 @@ public:
         progress = p;
     }
 
+    /*! \fn getWarmStart
+     * \brief Returns whether the solver starts from its last solution
+     */
+    bool getWarmStart (void)
+    {
+        return warmStart;
+    }
+
+    /*! \fn setWarmStart
+     * \brief Enables or disables warm starting the solver
+     * \param w new warm start flag
+     *
+     * When enabled, an iterative solver uses the solution of its
+     * previous run as the initial guess instead of the nodesets.
+     */
+    void setWarmStart (bool w)
+    {
+        warmStart = w;
+    }
+
+    /*! \fn getContinuation
+     * \brief Returns the parameter sweep the solver continues along
+     */
+    analysis * getContinuation (void)
+    {
+        return continuation;
+    }
+
+    /*! \fn setContinuation
+     * \brief Sets the parameter sweep the solver continues along
+     * \param a pointer to the parameter sweep or NULL
+     *
+     * A warm started solver continuing along a parameter sweep
+     * extrapolates its initial guess from the solutions of the
+     * previous sweep points and subdivides the sweep step if it
+     * fails to converge.
+     */
+    void setContinuation (analysis * a)
+    {
+        continuation = a;
+    }
+
+    /*! \fn getSweepPoint
+     * \brief Returns the index of the current sweep point
+     *
+     * Virtual function overridden by parameter sweeps.  It returns
+     * the number of sweep points solved in a row before the current
+     * one, i.e. zero for the start of a new continuation.
+     */
+    virtual int getSweepPoint (void)
+    {
+        return 0;
+    }
+
+    /*! \fn getSweepValue
+     * \brief Returns the current value of the swept parameter
+     */
+    virtual nr_double_t getSweepValue (void)
+    {
+        return 0;
+    }
+
+    /*! \fn setSweepValue
+     * \brief Sets the swept parameter to an intermediate value
+     * \param v new value of the parameter
+     *
+     * Virtual function overridden by parameter sweeps.  It updates
+     * the environment without saving any results.
+     */
+    virtual void setSweepValue (nr_double_t)
+    {
+    }
+
 protected:
     int runs;
     int type;
@@ -275,6 +382,8 @@ protected:
     environment * env;
     ptrlist<analysis> * actions;
     bool progress;
+    bool warmStart;
+    analysis * continuation;
 };
 
 } // namespace qucs
@@ -32,6 +32,8 @@
 #include <cmath>
 #include <assert.h>
 #include <float.h>
+#include <string>
+#include <unordered_map>
 
 #include "logging.h"
 #include "strlist.h"
@@ -46,10 +48,31 @@
 using namespace qucs;
 using namespace qucs::eqn;
 
-/* Global definitions for parser and checker. */
-struct definition_t * definition_root = NULL;
-struct definition_t * subcircuit_root = NULL;
-environment * env_root = NULL;
+/* Lookup table for the identifiers used in the properties of a single
+   definition list.  Identifiers are keyed by the definition type, the
+   property name and the identifier itself. */
+struct netlist_index_t {
+    struct definition_t * root;
+    std::unordered_map<std::string, struct value_t *> values;
+};
+
+/* The function creates an empty netlist context. */
+struct netlist_t * netlist_create (void)
+{
+    return (struct netlist_t *) calloc (sizeof (struct netlist_t), 1);
+}
+
+/* Deletes the given netlist context including its definition lists
+   and root environment. */
+void netlist_free (struct netlist_t * netlist)
+{
+    if (netlist != NULL)
+    {
+        netlist_destroy (netlist);
+        netlist_destroy_env (netlist);
+        free (netlist);
+    }
+}
 
 /* The function counts the nodes in a definition line. */
 static int checker_count_nodes (struct definition_t * def)
@@ -123,12 +146,57 @@ static int checker_count_definition (struct definition_t * root,
 /* Returns the value for a given definition type, key and variable
    identifier if it is in the list of definitions.  Otherwise the
    function returns NULL. */
-static struct value_t * checker_find_variable (struct definition_t * root,
+static std::string checker_index_key (const char * type, const char * key,
+                                      const char * ident)
+{
+    std::string k (type);
+    k += ':';
+    k += key;
+    k += '=';
+    k += ident;
+    return k;
+}
+
+/* The function creates the identifier lookup table for the given list
+   of definitions.  Only the first occurrence of an identifier is kept,
+   just like checker_find_variable() does. */
+static struct netlist_index_t *
+checker_create_index (struct definition_t * root)
+{
+    struct netlist_index_t * index = new netlist_index_t;
+    index->root = root;
+    for (struct definition_t * def = root; def != NULL; def = def->next)
+    {
+        for (struct pair_t * pair = def->pairs; pair != NULL; pair = pair->next)
+        {
+            if (pair->value != NULL && pair->value->ident != NULL)
+            {
+                index->values.emplace (checker_index_key (def->type, pair->key,
+                                       pair->value->ident), pair->value);
+            }
+        }
+    }
+    return index;
+}
+
+/* This function looks for the given identifier in the property 'key'
+   of the definitions of the given 'type'.  It returns the property
+   value or NULL if there is no such identifier.  The lookup table of
+   the netlist context is used if it belongs to the given list. */
+static struct value_t * checker_find_variable (struct netlist_t * netlist,
+        struct definition_t * root,
         const char * type,
         const char * key,
         char * ident)
 {
     struct pair_t * pair;
+    if (ident == NULL) return NULL;
+    if (netlist->index != NULL && netlist->index->root == root)
+    {
+        auto it = netlist->index->values.find (checker_index_key (type, key,
+                                               ident));
+        return it != netlist->index->values.end () ? it->second : NULL;
+    }
     for (struct definition_t * def = root; def != NULL; def = def->next)
     {
         if (!strcmp (def->type, type))
@@ -243,7 +311,8 @@ static variable * checker_add_variable (environment * env,
 
 /* Resolves the variable of a property value.  Returns non-zero on
    success, otherwise zero. */
-static int checker_resolve_variable (struct definition_t * root,
+static int checker_resolve_variable (struct netlist_t * netlist,
+                                     struct definition_t * root,
                                      struct definition_t * def,
                                      struct pair_t * pair, int type)
 {
@@ -253,7 +322,8 @@ static int checker_resolve_variable (struct definition_t * root,
     {
         int found = 0;
         /* 1. find variable in parameter sweeps */
-        if ((val = checker_find_variable (root, "SW", "Param", value->ident)))
+        if ((val = checker_find_variable (netlist, root, "SW", "Param",
+                                         value->ident)))
         {
             /* add parameter sweep variable to environment */
             if (!strcmp (def->type, "SW") && !strcmp (pair->key, "Param"))
@@ -267,7 +337,8 @@ static int checker_resolve_variable (struct definition_t * root,
             found++;
         }
         /* 2. find analysis in parameter sweeps */
-        if ((val = checker_find_variable (root, "SW", "Sim", value->ident)))
+        if ((val = checker_find_variable (netlist, root, "SW", "Sim",
+                                         value->ident)))
         {
             found++;
         }
@@ -278,7 +349,8 @@ static int checker_resolve_variable (struct definition_t * root,
             found++;
         }
         /* 4. find subcircuit definition in subcircuit components */
-        if ((val = checker_find_variable (root, "Sub", "Type", value->ident)))
+        if ((val = checker_find_variable (netlist, root, "Sub", "Type",
+                                         value->ident)))
         {
             found++;
         }
@@ -288,12 +360,14 @@ static int checker_resolve_variable (struct definition_t * root,
             found++;
         }
         /* 6. find file reference in S-parameter file components */
-        if ((val = checker_find_variable (root, "SPfile", "File", value->ident)))
+        if ((val = checker_find_variable (netlist, root, "SPfile", "File",
+                                         value->ident)))
         {
             found++;
         }
         /* 6a. find file reference in S-parameter de-embedding file components */
-        if ((val = checker_find_variable (root, "SPDfile", "File", value->ident)))
+        if ((val = checker_find_variable (netlist, root, "SPDfile", "File",
+                                         value->ident)))
         {
             found++;
         }
@@ -313,11 +387,13 @@ static int checker_resolve_variable (struct definition_t * root,
             }
         }
         /* 8. find file reference in file based sources */
-        if ((val = checker_find_variable (root, "Vfile", "File", value->ident)))
+        if ((val = checker_find_variable (netlist, root, "Vfile", "File",
+                                         value->ident)))
         {
             found++;
         }
-        if ((val = checker_find_variable (root, "Ifile", "File", value->ident)))
+        if ((val = checker_find_variable (netlist, root, "Ifile", "File",
+                                         value->ident)))
         {
             found++;
         }
@@ -513,10 +589,11 @@ static int checker_count_definitions (struct definition_t * root,
 /* This function looks for the specified subcircuit type in the list
    of available subcircuits and returns its definition.  If there is
    no such subcircuit the function returns NULL: */
-static struct definition_t * checker_find_subcircuit (char * n)
+static struct definition_t *
+checker_find_subcircuit (struct netlist_t * netlist, char * n)
 {
     struct definition_t * def;
-    for (def = subcircuit_root; def != NULL; def = def->next)
+    for (def = netlist->subcircuit_root; def != NULL; def = def->next)
         if (n != NULL && !strcmp (def->instance, n)) return def;
     return NULL;
 }
@@ -524,21 +601,19 @@ static struct definition_t * checker_find_subcircuit (char * n)
 /* The function returns the subcircuit definition for the given
    subcircuit instance. */
 static struct definition_t *
-checker_get_subcircuit (struct definition_t * def)
+checker_get_subcircuit (struct netlist_t * netlist, struct definition_t * def)
 {
     struct value_t * val;
     struct definition_t * sub = NULL;
     if ((val = checker_find_reference (def, "Type")) != NULL)
-        sub = checker_find_subcircuit (val->ident);
+        sub = checker_find_subcircuit (netlist, val->ident);
     return sub;
 }
 
-// Global variable indicating cycles in subcircuit definitions.
-static int checker_sub_cycles = 0;
-
 /* The following function returns the number of circuit instances
    requiring a DC analysis (being nonlinear) in the list of definitions. */
-static int checker_count_nonlinearities (struct definition_t * root)
+static int checker_count_nonlinearities (struct netlist_t * netlist,
+                                         struct definition_t * root)
 {
     int count = 0;
     struct definition_t * sub;
@@ -546,13 +621,13 @@ static int checker_count_nonlinearities (struct definition_t * root)
     {
         if (def->nonlinear != 0) count++;
         // also recurse into subcircuits if possible
-        if (checker_sub_cycles <= 0)
+        if (netlist->sub_cycles <= 0)
         {
             if (!strcmp (def->type, "Sub"))
             {
-                if ((sub = checker_get_subcircuit (def)) != NULL)
+                if ((sub = checker_get_subcircuit (netlist, def)) != NULL)
                 {
-                    count += checker_count_nonlinearities (sub->sub);
+                    count += checker_count_nonlinearities (netlist, sub->sub);
                 }
             }
         }
@@ -844,7 +919,8 @@ static int checker_validate_lists (struct definition_t * root)
 
 /* This function checks the actions to be taken in the netlist.  It
    returns zero on success, non-zero otherwise. */
-static int checker_validate_actions (struct definition_t * root)
+static int checker_validate_actions (struct netlist_t * netlist,
+                                     struct definition_t * root)
 {
     int a, c, n, errors = 0;
     if ((n = checker_count_definitions (root, NULL, 1)) < 1)
@@ -867,7 +943,7 @@ static int checker_validate_actions (struct definition_t * root)
         // count analyses requiring a DC solution
         a += checker_count_definitions (root, "AC", 1);
         // check dc-analysis requirements
-        c = checker_count_nonlinearities (root);
+        c = checker_count_nonlinearities (netlist, root);
         n = checker_count_definitions (root, "DC", 1);
         if (n > 1)
         {
@@ -1069,9 +1145,9 @@ static int netlist_checker_variables_intern (struct definition_t * root,
 
 /* This is the overall variable checker for the parsed netlist.  See
    the above function for details. */
-int netlist_checker_variables (environment * env)
+int netlist_checker_variables (struct netlist_t * netlist, environment * env)
 {
-    return netlist_checker_variables_intern (definition_root, env);
+    return netlist_checker_variables_intern (netlist->definition_root, env);
 }
 
 /* The function checks whether the given key-value combination is
@@ -1234,7 +1310,8 @@ static int checker_value_in_range (char * instance, struct define_t * def,
    list.  It returns the given definition list with the subcircuits
    removed. */
 static struct definition_t *
-checker_build_subcircuits (struct definition_t * root)
+checker_build_subcircuits (struct netlist_t * netlist,
+                           struct definition_t * root)
 {
     struct definition_t * def, * next, * prev;
     for (prev = NULL, def = root; def != NULL; def = next)
@@ -1250,9 +1327,9 @@ checker_build_subcircuits (struct definition_t * root)
             {
                 root = next;
             }
-            def->sub = checker_build_subcircuits (def->sub);
-            def->next = subcircuit_root;
-            subcircuit_root = def;
+            def->sub = checker_build_subcircuits (netlist, def->sub);
+            def->next = netlist->subcircuit_root;
+            netlist->subcircuit_root = def;
         }
         else prev = def;
     }
@@ -1501,7 +1578,8 @@ static char * checker_subcircuit_instance (char * type, char * instances,
    instances and node names.  The function returns a NULL terminated
    circuit element list in reverse order. */
 static struct definition_t *
-checker_copy_subcircuits (struct definition_t * type,
+checker_copy_subcircuits (struct netlist_t * netlist,
+                          struct definition_t * type,
                           struct definition_t * inst, strlist * * instances,
                           environment * parent)
 {
@@ -1545,13 +1623,14 @@ checker_copy_subcircuits (struct definition_t * type,
         if (!strcmp (def->type, "Sub"))
         {
             // get subcircuit template definition
-            struct definition_t * sub = checker_get_subcircuit (def);
+            struct definition_t * sub = checker_get_subcircuit (netlist, def);
             // create a copy of the current subcircuit instance list
             if ((*instances) == NULL) (*instances) = new strlist ();
             instcopy = new strlist (*(*instances));
             // append instance name to recursive instance list
             (*instances)->append (inst->instance);
-            copy = checker_copy_subcircuits (sub, def, instances, child);
+            copy = checker_copy_subcircuits (netlist, sub, def, instances,
+                                             child);
             // put the expanded definitions into the sublist
             if (copy)
             {
@@ -1609,7 +1688,8 @@ checker_copy_subcircuits (struct definition_t * type,
    through the definitions and emits an appropriate error message if
    necessary.  The function returns zero if there are no cycles
    detected and non-zero with cycles found. */
-static int checker_validate_sub_cycles (struct definition_t * root,
+static int checker_validate_sub_cycles (struct netlist_t * netlist,
+                                        struct definition_t * root,
                                         char * type, char * instance,
                                         strlist * * deps)
 {
@@ -1645,9 +1725,10 @@ static int checker_validate_sub_cycles (struct definition_t * root,
                     // copy current dependencies
                     strlist * copy = new strlist (*(*deps));
                     // validate subcircuit
-                    sub = checker_find_subcircuit (val->ident);
+                    sub = checker_find_subcircuit (netlist, val->ident);
                     if (sub != NULL) // if possible
-                        error = checker_validate_sub_cycles (sub, sub->instance,
+                        error = checker_validate_sub_cycles (netlist, sub,
+                                                             sub->instance,
                                                              instance, deps);
                     else
                         error = 1;
@@ -1765,7 +1846,8 @@ static void netlist_free_define (struct define_t * d)
 /* The function checks the presence of required and optional
    properties as well as their content in the given definition.  It
    returns zero on success and non-zero otherwise. */
-static int checker_validate_properties (struct definition_t * root,
+static int checker_validate_properties (struct netlist_t * netlist,
+                                        struct definition_t * root,
                                         struct definition_t * def,
                                         struct define_t * available)
 {
@@ -1825,7 +1907,7 @@ static int checker_validate_properties (struct definition_t * root,
                 errors++;
             }
             /* check variables in properties */
-            if (!checker_resolve_variable (root, def, pair, type))
+            if (!checker_resolve_variable (netlist, root, def, pair, type))
                 errors++;
         }
     }
@@ -1835,7 +1917,8 @@ static int checker_validate_properties (struct definition_t * root,
 /* This function is used by the netlist checker to validate the
    subcircuits.  It returns zero with no errors and non-zero on
    errors. */
-static int checker_validate_subcircuits (struct definition_t * root)
+static int checker_validate_subcircuits (struct netlist_t * netlist,
+                                         struct definition_t * root)
 {
     int errors = 0;
     // go through list of definitions
@@ -1853,7 +1936,8 @@ static int checker_validate_subcircuits (struct definition_t * root)
             else
             {
                 // find an appropriate subcircuit type
-                struct definition_t * sub = checker_find_subcircuit (val->ident);
+                struct definition_t * sub =
+                    checker_find_subcircuit (netlist, val->ident);
                 if (sub == NULL)
                 {
                     logprint (LOG_ERROR, "line %d: checker error, no such subcircuit "
@@ -1876,14 +1960,16 @@ static int checker_validate_subcircuits (struct definition_t * root)
                     }
                     // check the subcircuit instance properties
                     struct define_t * available = netlist_create_define (sub);
-                    errors += checker_validate_properties (root, def, available);
+                    errors += checker_validate_properties (netlist, root, def,
+                                                           available);
                     netlist_free_define (available);
                     // and finally check for cyclic definitions
                     strlist * deps = new strlist ();
-                    int err = checker_validate_sub_cycles (sub, sub->instance,
+                    int err = checker_validate_sub_cycles (netlist, sub,
+                                                           sub->instance,
                                                            def->instance, &deps);
                     errors += err;
-                    checker_sub_cycles = err;
+                    netlist->sub_cycles = err;
                     delete deps;
                 }
             }
@@ -1932,7 +2018,7 @@ static void netlist_free_pairs (struct pair_t * pp)
 }
 
 /* Deletes the given definition. */
-static void netlist_free_definition (struct definition_t * def)
+void netlist_free_definition (struct definition_t * def)
 {
     netlist_free_nodes (def->nodes);
     if (!def->copy) netlist_free_pairs (def->pairs);
@@ -1967,69 +2053,47 @@ netlist_unchain_definition (struct definition_t * root,
     return root;
 }
 
-/* The function expands the subcircuits within the given definition
-   list and returns the expanded list with the subcircuit definitions
-   removed. */
-static struct definition_t *
-checker_expand_subcircuits (struct definition_t * root, environment * parent)
+/* The function expands the given subcircuit instance into the
+   components of its subcircuit type, including the ones of nested
+   subcircuits, and returns the list of the created component
+   definitions.  The subcircuit definitions themselves are shared by
+   all instances, thus only the instance being expanded is duplicated. */
+struct definition_t *
+netlist_expand_subcircuit (struct netlist_t * netlist,
+                           struct definition_t * inst)
 {
-    struct definition_t * def, * sub, * copy, * next, * prev;
     strlist * instances = NULL;
-
-    // go through the list of definitions
-    for (prev = NULL, def = root; def != NULL; def = next)
-    {
-        next = def->next;
-        // is this a subcircuit instance definition ?
-        if (!strcmp (def->type, "Sub"))
-        {
-            // get the subcircuit type definition
-            sub = checker_get_subcircuit (def);
-            // and make a copy of it
-            copy = checker_copy_subcircuits (sub, def, &instances, parent);
-            if (instances)
-            {
-                delete instances;
-                instances = NULL;
-            }
-            // remove the subcircuit instance from the original list
-            if (prev)
-            {
-                prev->next = next;
-            }
-            else
-            {
-                root = next;
-            }
-            netlist_free_definition (def);
-            // put the expanded definitions into the netlist
-            if (copy)
-            {
-                struct definition_t * last = checker_find_last_definition (copy);
-                last->next = root;
-                if (!prev) prev = last;
-                root = copy;
-            }
-        }
-        // component in the root environment
-        else
-        {
-            prev = def;
-            def->env = parent;
-        }
-    }
-    return root;
+    // get the subcircuit type definition
+    struct definition_t * sub = checker_get_subcircuit (netlist, inst);
+    // and make a copy of it
+    struct definition_t * copy =
+        checker_copy_subcircuits (netlist, sub, inst, &instances, inst->env);
+    delete instances;
+    return copy;
 }
 
 /* This function is the checker routine for a parsed netlist.  It
    returns zero on success or non-zero if the parsed netlist contained
    errors. */
-static int netlist_checker_intern (struct definition_t * root)
+static int netlist_checker_intern (struct netlist_t * netlist,
+                                   struct definition_t * root)
 {
     struct definition_t * def;
     struct define_t * available;
     int n, errors = 0;
 
+    /* create the identifier lookup table for the definitions */
+    netlist->index = checker_create_index (root);
+
+    /* count the definitions of each type and instance name */
+    std::unordered_map<std::string, int> count;
+    for (def = root; def != NULL; def = def->next)
+    {
+        std::string key = std::string (def->type) + ':' + def->instance;
+        if (++count[key] > 1)
+            def->duplicate = 1;
+    }
+
     /* go through all definitions */
     for (def = root; def != NULL; def = def->next)
     {
@@ -2077,11 +2141,11 @@ static int netlist_checker_intern (struct definition_t * root)
             /* check the properties except for subcircuits */
             if (strcmp (def->type, "Sub"))
             {
-                errors += checker_validate_properties (root, def, available);
+                errors += checker_validate_properties (netlist, root, def, available);
             }
         }
         /* check the number of definitions */
-        n = checker_count_definition (root, def->type, def->instance);
+        n = count[std::string (def->type) + ':' + def->instance];
         if (n != 1 && def->duplicate == 0)
         {
             logprint (LOG_ERROR, "checker error, found %d definitions of `%s:%s'\n",
@@ -2092,9 +2156,12 @@ static int netlist_checker_intern (struct definition_t * root)
     /* check microstrip definitions */
     errors += checker_validate_strips (root);
     /* check subcircuit definitions */
-    errors += checker_validate_subcircuits (root);
+    errors += checker_validate_subcircuits (netlist, root);
     /* check nodeset definitions */
     errors += checker_validate_nodesets (root);
+
+    delete netlist->index;
+    netlist->index = NULL;
     return errors;
 }
 
@@ -2147,12 +2214,12 @@ static void netlist_lister (struct definition_t * root, const char * prefix)
 }
 
 /* Debug function: Prints the overall netlist representation. */
-void netlist_list (void)
+void netlist_list (struct netlist_t * netlist)
 {
     struct definition_t * def;
     logprint (LOG_STATUS, "subcircuit %s\n", "root");
-    netlist_lister (definition_root, "  ");
-    for (def = subcircuit_root; def != NULL; def = def->next)
+    netlist_lister (netlist->definition_root, "  ");
+    for (def = netlist->subcircuit_root; def != NULL; def = def->next)
     {
         logprint (LOG_STATUS, "subcircuit %s\n", def->instance);
         netlist_lister (def->sub, "  ");
@@ -2160,25 +2227,40 @@ void netlist_list (void)
 }
 #endif /* DEBUG */
 
+/* The function counts the component instances of the given list of
+   definitions by type.  Subcircuit instances are accounted by the
+   components of their subcircuit type. */
+static void netlist_count_instances (struct netlist_t * netlist,
+                                     struct definition_t * root,
+                                     std::unordered_map<std::string, int> & n)
+{
+    struct definition_t * sub;
+    for (struct definition_t * def = root; def != NULL; def = def->next)
+    {
+        if (!strcmp (def->type, "Sub") && netlist->sub_cycles <= 0 &&
+                (sub = checker_get_subcircuit (netlist, def)) != NULL)
+            netlist_count_instances (netlist, sub->sub, n);
+        else
+            n[def->type]++;
+    }
+}
+
 /* The function logs the content of the current netlist by telling how
    many instances of which kind of components are used in the netlist. */
-void netlist_status (void)
+void netlist_status (struct netlist_t * netlist)
 {
     struct define_t * def;
-    struct definition_t * cir;
-    int count;
+    std::unordered_map<std::string, int> count;
+    netlist_count_instances (netlist, netlist->definition_root, count);
     logprint (LOG_STATUS, "netlist content\n");
     hashiterator<module> it;
     for (it = hashiterator<module> (module::modules); *it; ++it)
     {
         def = it.currentVal()->definition;
-        for (count = 0, cir = definition_root; cir != NULL; cir = cir->next)
-        {
-            if (!strcmp (def->type, cir->type)) count++;
-        }
-        if (count > 0)
+        auto n = count.find (def->type);
+        if (n != count.end () && n->second > 0)
         {
-            logprint (LOG_STATUS, "  %5d %s instances\n", count, def->type);
+            logprint (LOG_STATUS, "  %5d %s instances\n", n->second, def->type);
         }
     }
 }
@@ -2263,43 +2345,45 @@ static void checker_subcircuit_args (struct definition_t * def,
 
 /* This is the global netlist checker.  It returns zero on success and
    non-zero on errors. */
-int netlist_checker (environment * env)
+int netlist_checker (struct netlist_t * netlist, environment * env)
 {
     int errors = 0;
     eqn::node * eqns;
     struct definition_t * def;
 
     // create top-level environment
-    env_root = new environment (env->getName ());
+    netlist->env_root = new environment (env->getName ());
     // create the subcircuit list
-    definition_root = checker_build_subcircuits (definition_root);
+    netlist->definition_root =
+        checker_build_subcircuits (netlist, netlist->definition_root);
     // get equation list
-    definition_root = checker_build_equations (definition_root, &eqns);
+    netlist->definition_root =
+        checker_build_equations (netlist->definition_root, &eqns);
     // setup the root environment
-    checker_setup_env (definition_root, env_root, eqns);
+    checker_setup_env (netlist->definition_root, netlist->env_root, eqns);
     // check list of subcircuits
-    errors += netlist_checker_intern (subcircuit_root);
+    errors += netlist_checker_intern (netlist, netlist->subcircuit_root);
     // check global netlist
-    errors += netlist_checker_intern (definition_root);
+    errors += netlist_checker_intern (netlist, netlist->definition_root);
     // check equations in root
-    env_root->setDefinitions (definition_root);
-    errors += env_root->equationChecker (0);
-    env_root->setDefinitions (NULL);
+    netlist->env_root->setDefinitions (netlist->definition_root);
+    errors += netlist->env_root->equationChecker (0);
+    netlist->env_root->setDefinitions (NULL);
 
     // then check each subcircuit list
-    for (def = subcircuit_root; def != NULL; def = def->next)
+    for (def = netlist->subcircuit_root; def != NULL; def = def->next)
     {
         // get equation list
         def->sub = checker_build_equations (def->sub, &eqns);
         // setup the subcircuit environment
         environment * subenv = new environment (def->instance);
-        env_root->push_front_Child (subenv);
+        netlist->env_root->push_front_Child (subenv);
         checker_setup_env (def, subenv, eqns);
         if (def->sub) def->sub->env = subenv;
         // add subcircuit parameters to equations
         checker_subcircuit_args (def, subenv);
         // check subcircuit netlist
-        errors += netlist_checker_intern (def->sub);
+        errors += netlist_checker_intern (netlist, def->sub);
         // check equations in subcircuit
         subenv->setDefinitions (def->sub);
         errors += subenv->equationChecker (0);
@@ -2307,14 +2391,15 @@ int netlist_checker (environment * env)
     }
 
     // check actions
-    errors += checker_validate_actions (definition_root);
+    errors += checker_validate_actions (netlist, netlist->definition_root);
 
     if (!errors)
     {
         // create actual root environment
-        env->copy (*env_root);
-        // and finally expand the subcircuits into the global netlist
-        definition_root = checker_expand_subcircuits (definition_root, env);
+        env->copy (*netlist->env_root);
+        // the subcircuit instances are expanded on demand later on
+        for (def = netlist->definition_root; def != NULL; def = def->next)
+            def->env = env;
     }
 
     return errors ? -1 : 0;
@@ -2332,25 +2417,25 @@ static void netlist_destroy_intern (struct definition_t * root)
 }
 
 /* Deletes all available definition lists. */
-void netlist_destroy (void)
+void netlist_destroy (struct netlist_t * netlist)
 {
-    netlist_destroy_intern (definition_root);
-    for (struct definition_t * def = subcircuit_root; def; def = def->next)
+    netlist_destroy_intern (netlist->definition_root);
+    struct definition_t * def;
+    for (def = netlist->subcircuit_root; def != NULL; def = def->next)
     {
         netlist_destroy_intern (def->sub);
     }
-    netlist_destroy_intern (subcircuit_root);
-    definition_root = subcircuit_root = NULL;
-    netlist_lex_destroy ();
+    netlist_destroy_intern (netlist->subcircuit_root);
+    netlist->definition_root = netlist->subcircuit_root = NULL;
 }
 
 /* Delete root environment(s) if necessary. */
-void netlist_destroy_env (void)
+void netlist_destroy_env (struct netlist_t * netlist)
 {
-    if (env_root != NULL)
+    if (netlist->env_root != NULL)
     {
-        delete env_root;
-        env_root = NULL;
+        delete netlist->env_root;
+        netlist->env_root = NULL;
     }
 }
 
@@ -32,30 +32,41 @@ namespace qucs {
   class environment;
 }
 
-/* Externalize variables used by the scanner and parser. */
-extern int netlist_lineno;
-extern FILE * netlist_in;
+/* The netlist context holds the complete state of the parser and the
+   checker for a single netlist.  Each context is independent of all
+   others, thus several netlists can be loaded at the same time. */
+struct netlist_t {
+  struct definition_t * definition_root; /* the parsed definitions */
+  struct definition_t * subcircuit_root; /* the subcircuit definitions */
+  qucs::environment * env_root;          /* top-level checker environment */
+  int sub_cycles;                        /* cycles in subcircuits */
+  struct netlist_index_t * index;        /* identifier lookup table */
+};
 
-__BEGIN_DECLS
+/* Available functions of the parser. */
+int  netlist_parse (void *);
+int  netlist_parse_file (struct netlist_t *, FILE *);
+int  netlist_parse_buffer (struct netlist_t *, const char *, int);
+int  netlist_error (void *, const char *);
 
-/* Externalize variables used by the scanner and parser. */
-extern struct definition_t * definition_root;
+__BEGIN_DECLS
 
 /* Available functions of the checker. */
-void netlist_status (void);
-void netlist_list (void);
-void netlist_destroy (void);
-void netlist_destroy_env (void);
-int  netlist_checker (qucs::environment *);
-int  netlist_parse (void);
-int  netlist_error (const char *);
-int  netlist_lex (void);
-int  netlist_lex_destroy (void);
-int  netlist_checker_variables (qucs::environment *);
+struct netlist_t * netlist_create (void);
+void netlist_free (struct netlist_t *);
+void netlist_status (struct netlist_t *);
+void netlist_list (struct netlist_t *);
+void netlist_destroy (struct netlist_t *);
+void netlist_destroy_env (struct netlist_t *);
+int  netlist_checker (struct netlist_t *, qucs::environment *);
+int  netlist_checker_variables (struct netlist_t *, qucs::environment *);
 
 /* Some more functionality. */
 struct definition_t *
 netlist_unchain_definition (struct definition_t *, struct definition_t *);
+struct definition_t *
+netlist_expand_subcircuit (struct netlist_t *, struct definition_t *);
+void netlist_free_definition (struct definition_t *);
 
 __END_DECLS
 
@@ -30,6 +30,8 @@
 #include <stdlib.h>
 #include <string.h>
 #include <assert.h>
+#include <cmath>
+#include <algorithm>
 
 #include "logging.h"
 #include "complex.h"
@@ -60,6 +62,9 @@ circuit::circuit () : object (), integrator () {
   VectorQ = VectorE = VectorI = VectorV = VectorJ = NULL;
   MatrixQV = NULL;
   VectorCV = VectorGV = NULL;
+  VectorVB = NULL;
+  MatrixYr = MatrixBr = MatrixCr = MatrixDr = NULL;
+  VectorEr = VectorIr = VectorVr = VectorJr = NULL;
   nodes = NULL;
   pacport = 0;
   pol = 1;
@@ -89,6 +94,9 @@ circuit::circuit (int s) : object (), integrator () {
   VectorQ = VectorE = VectorI = VectorV = VectorJ = NULL;
   MatrixQV = NULL;
   VectorCV = VectorGV = NULL;
+  VectorVB = NULL;
+  MatrixYr = MatrixBr = MatrixCr = MatrixDr = NULL;
+  VectorEr = VectorIr = VectorVr = VectorJr = NULL;
   pacport = 0;
   pol = 1;
   flag = CIRCUIT_ORIGINAL | CIRCUIT_LINEAR;
@@ -113,7 +121,7 @@ circuit::circuit (const circuit & c) : object (c), integrator (c) {
   size = c.size;
   pol = c.pol;
   pacport = c.pacport;
-  flag = c.flag;
+  flag = c.flag & ~CIRCUIT_BYPASSVALID;
   type = c.type;
   subst = c.subst;
   vsource = c.vsource;
@@ -124,6 +132,11 @@ circuit::circuit (const circuit & c) : object (c), integrator (c) {
   deltas = c.deltas;
   nHistories = c.nHistories;
   histories = NULL;
+  VectorVB = NULL;
+  MatrixY = MatrixB = MatrixC = MatrixD = NULL;
+  VectorE = VectorI = VectorV = VectorJ = NULL;
+  MatrixYr = MatrixBr = MatrixCr = MatrixDr = NULL;
+  VectorEr = VectorIr = VectorVr = VectorJr = NULL;
   subcircuit = c.subcircuit;
 
   if (size > 0) {
@@ -166,6 +179,20 @@ circuit::circuit (const circuit & c) : object (c), integrator (c) {
 	memcpy (VectorJ, c.VectorJ, vsources * sizeof (nr_complex_t));
       }
     }
+    // copy each real valued MNA matrix entry
+    if (c.MatrixYr) {
+      allocMatrixMNA ();
+      memcpy (MatrixYr, c.MatrixYr, size * size * sizeof (nr_double_t));
+      memcpy (VectorIr, c.VectorIr, size * sizeof (nr_double_t));
+      memcpy (VectorVr, c.VectorVr, size * sizeof (nr_double_t));
+      if (vsources > 0) {
+	memcpy (MatrixBr, c.MatrixBr, vsources * size * sizeof (nr_double_t));
+	memcpy (MatrixCr, c.MatrixCr, vsources * size * sizeof (nr_double_t));
+	memcpy (MatrixDr, c.MatrixDr, vsources * vsources * sizeof (nr_double_t));
+	memcpy (VectorEr, c.VectorEr, vsources * sizeof (nr_double_t));
+	memcpy (VectorJr, c.VectorJr, vsources * sizeof (nr_double_t));
+      }
+    }
   }
   else {
     nodes = NULL;
@@ -266,13 +293,29 @@ void circuit::allocMatrixN (int sources) {
   MatrixN = new nr_complex_t[(size + sources) * (size + sources)];
 }
 
-/* Allocates the matrix memory for the MNA matrices. */
+/* Allocates the matrix memory for the MNA matrices.  Circuits in real
+   valued mode, i.e. during the DC, transient and HB time domain
+   evaluations, get real valued matrices only. */
 void circuit::allocMatrixMNA (void) {
   freeMatrixMNA ();
-  if (size > 0) {
+  if (size > 0 && isRealMNA ()) {
+    MatrixYr = new nr_double_t[size * size] ();
+    VectorIr = new nr_double_t[size] ();
+    VectorVr = new nr_double_t[size] ();
+    VectorVB = new nr_double_t[size];
+    if (vsources > 0) {
+      MatrixBr = new nr_double_t[vsources * size] ();
+      MatrixCr = new nr_double_t[vsources * size] ();
+      MatrixDr = new nr_double_t[vsources * vsources] ();
+      VectorEr = new nr_double_t[vsources] ();
+      VectorJr = new nr_double_t[vsources] ();
+    }
+  }
+  else if (size > 0) {
     MatrixY = new nr_complex_t[size * size];
     VectorI = new nr_complex_t[size];
     VectorV = new nr_complex_t[size];
+    VectorVB = new nr_double_t[size];
     if (vsources > 0) {
       MatrixB = new nr_complex_t[vsources * size];
       MatrixC = new nr_complex_t[vsources * size];
@@ -293,6 +336,66 @@ void circuit::freeMatrixMNA (void) {
   if (VectorI) { delete[] VectorI; VectorI = NULL; }
   if (VectorV) { delete[] VectorV; VectorV = NULL; }
   if (VectorJ) { delete[] VectorJ; VectorJ = NULL; }
+  if (VectorVB) { delete[] VectorVB; VectorVB = NULL; }
+  if (MatrixYr) { delete[] MatrixYr; MatrixYr = NULL; }
+  if (MatrixBr) { delete[] MatrixBr; MatrixBr = NULL; }
+  if (MatrixCr) { delete[] MatrixCr; MatrixCr = NULL; }
+  if (MatrixDr) { delete[] MatrixDr; MatrixDr = NULL; }
+  if (VectorEr) { delete[] VectorEr; VectorEr = NULL; }
+  if (VectorIr) { delete[] VectorIr; VectorIr = NULL; }
+  if (VectorVr) { delete[] VectorVr; VectorVr = NULL; }
+  if (VectorJr) { delete[] VectorJr; VectorJr = NULL; }
+  flag &= ~CIRCUIT_BYPASSVALID;
+}
+
+// Converts the given real valued array into a complex valued one.
+static nr_complex_t * toComplexMNA (nr_double_t * & r, int n) {
+  if (r == NULL) return NULL;
+  nr_complex_t * z = new nr_complex_t[n];
+  for (int i = 0; i < n; i++) z[i] = r[i];
+  delete[] r;
+  r = NULL;
+  return z;
+}
+
+// Converts the given complex valued array into a real valued one.
+static nr_double_t * toRealMNA (nr_complex_t * & z, int n) {
+  if (z == NULL) return NULL;
+  nr_double_t * r = new nr_double_t[n];
+  for (int i = 0; i < n; i++) r[i] = real (z[i]);
+  delete[] z;
+  z = NULL;
+  return r;
+}
+
+/* The function switches the circuit between real and complex valued
+   MNA matrices.  Already allocated matrices are converted keeping
+   their entries, thus circuits which do not reallocate them during
+   the initialization of an analysis can still be used. */
+void circuit::setRealMNA (bool r) {
+  if (r == isRealMNA ()) return;
+  MODFLAG (r, CIRCUIT_REALMNA);
+  int n = size * size, m = vsources * size, d = vsources * vsources;
+  if (r) {
+    MatrixYr = toRealMNA (MatrixY, n);
+    MatrixBr = toRealMNA (MatrixB, m);
+    MatrixCr = toRealMNA (MatrixC, m);
+    MatrixDr = toRealMNA (MatrixD, d);
+    VectorEr = toRealMNA (VectorE, vsources);
+    VectorIr = toRealMNA (VectorI, size);
+    VectorVr = toRealMNA (VectorV, size);
+    VectorJr = toRealMNA (VectorJ, vsources);
+  }
+  else {
+    MatrixY = toComplexMNA (MatrixYr, n);
+    MatrixB = toComplexMNA (MatrixBr, m);
+    MatrixC = toComplexMNA (MatrixCr, m);
+    MatrixD = toComplexMNA (MatrixDr, d);
+    VectorE = toComplexMNA (VectorEr, vsources);
+    VectorI = toComplexMNA (VectorIr, size);
+    VectorV = toComplexMNA (VectorVr, size);
+    VectorJ = toComplexMNA (VectorJr, vsources);
+  }
 }
 
 /* This function sets the name and port number of one of the circuit's
@@ -343,72 +446,114 @@ void circuit::setSubstrate (substrate * s) {
 /* Returns the circuits B-MNA matrix value of the given voltage source
    built in the circuit depending on the port number. */
 nr_complex_t circuit::getB (int port, int nr) {
+  if (MatrixBr) return MatrixBr[(nr - vsource) * size + port];
   return MatrixB[(nr - vsource) * size + port];
 }
 
 /* Sets the circuits B-MNA matrix value of the given voltage source
    built in the circuit depending on the port number. */
 void circuit::setB (int port, int nr, nr_complex_t z) {
-  MatrixB[nr * size + port] = z;
+  if (MatrixBr) MatrixBr[nr * size + port] = real (z);
+  else MatrixB[nr * size + port] = z;
+}
+
+/* Same as above with different argument type. */
+void circuit::setB (int port, int nr, nr_double_t z) {
+  if (MatrixBr) MatrixBr[nr * size + port] = z;
+  else MatrixB[nr * size + port] = z;
 }
 
 /* Returns the circuits C-MNA matrix value of the given voltage source
    built in the circuit depending on the port number. */
 nr_complex_t circuit::getC (int nr, int port) {
+  if (MatrixCr) return MatrixCr[(nr - vsource) * size + port];
   return MatrixC[(nr - vsource) * size + port];
 }
 
 /* Sets the circuits C-MNA matrix value of the given voltage source
    built in the circuit depending on the port number. */
 void circuit::setC (int nr, int port, nr_complex_t z) {
-  MatrixC[nr * size + port] = z;
+  if (MatrixCr) MatrixCr[nr * size + port] = real (z);
+  else MatrixC[nr * size + port] = z;
+}
+
+/* Same as above with different argument type. */
+void circuit::setC (int nr, int port, nr_double_t z) {
+  if (MatrixCr) MatrixCr[nr * size + port] = z;
+  else MatrixC[nr * size + port] = z;
 }
 
 /* Returns the circuits D-MNA matrix value of the given voltage source
    built in the circuit. */
 nr_complex_t circuit::getD (int r, int c) {
+  if (MatrixDr) return MatrixDr[(r - vsource) * vsources + c - vsource];
   return MatrixD[(r - vsource) * vsources + c - vsource];
 }
 
 /* Sets the circuits D-MNA matrix value of the given voltage source
    built in the circuit. */
 void circuit::setD (int r, int c, nr_complex_t z) {
-  MatrixD[r * vsources + c] = z;
+  if (MatrixDr) MatrixDr[r * vsources + c] = real (z);
+  else MatrixD[r * vsources + c] = z;
+}
+
+/* Same as above with different argument type. */
+void circuit::setD (int r, int c, nr_double_t z) {
+  if (MatrixDr) MatrixDr[r * vsources + c] = z;
+  else MatrixD[r * vsources + c] = z;
 }
 
 /* Returns the circuits E-MNA matrix value of the given voltage source
    built in the circuit. */
 nr_complex_t circuit::getE (int nr) {
+  if (VectorEr) return VectorEr[nr - vsource];
   return VectorE[nr - vsource];
 }
 
 /* Sets the circuits E-MNA matrix value of the given voltage source
    built in the circuit. */
 void circuit::setE (int nr, nr_complex_t z) {
-  VectorE[nr] = z;
+  if (VectorEr) VectorEr[nr] = real (z);
+  else VectorE[nr] = z;
+}
+
+/* Same as above with different argument type. */
+void circuit::setE (int nr, nr_double_t z) {
+  if (VectorEr) VectorEr[nr] = z;
+  else VectorE[nr] = z;
 }
 
 /* Returns the circuits I-MNA matrix value of the current source built
    in the circuit. */
 nr_complex_t circuit::getI (int port) {
+  if (VectorIr) return VectorIr[port];
   return VectorI[port];
 }
 
 /* Sets the circuits I-MNA matrix value of the current source built in
    the circuit depending on the port number. */
 void circuit::setI (int port, nr_complex_t z) {
-  VectorI[port] = z;
+  if (VectorIr) VectorIr[port] = real (z);
+  else VectorI[port] = z;
+}
+
+/* Same as above with different argument type. */
+void circuit::setI (int port, nr_double_t z) {
+  if (VectorIr) VectorIr[port] = z;
+  else VectorI[port] = z;
 }
 
 /* Modifies the circuits I-MNA matrix value of the current source
    built in the circuit depending on the port number. */
 void circuit::addI (int port, nr_complex_t i) {
-  VectorI[port] += i;
+  if (VectorIr) VectorIr[port] += real (i);
+  else VectorI[port] += i;
 }
 
 /* Same as above with different argument type. */
 void circuit::addI (int port, nr_double_t i) {
-  VectorI[port] += i;
+  if (VectorIr) VectorIr[port] += i;
+  else VectorI[port] += i;
 }
 
 /* Returns the circuits Q-HB vector value. */
@@ -424,58 +569,121 @@ void circuit::setQ (int port, nr_complex_t q) {
 /* Returns the circuits J-MNA matrix value of the given voltage source
    built in the circuit. */
 nr_complex_t circuit::getJ (int nr) {
+  if (VectorJr) return VectorJr[nr];
   return VectorJ[nr];
 }
 
 /* Sets the circuits J-MNA matrix value of the given voltage source
    built in the circuit. */
 void circuit::setJ (int nr, nr_complex_t z) {
-  VectorJ[nr - vsource] = z;
+  if (VectorJr) VectorJr[nr - vsource] = real (z);
+  else VectorJ[nr - vsource] = z;
+}
+
+/* Same as above with different argument type. */
+void circuit::setJ (int nr, nr_double_t z) {
+  if (VectorJr) VectorJr[nr - vsource] = z;
+  else VectorJ[nr - vsource] = z;
 }
 
 // Returns the circuits voltage value at the given port.
 nr_complex_t circuit::getV (int port) {
+  if (VectorVr) return VectorVr[port];
   return VectorV[port];
 }
 
 // Sets the circuits voltage value at the given port.
 void circuit::setV (int port, nr_complex_t z) {
-  VectorV[port] = z;
+  if (VectorVr) VectorVr[port] = real (z);
+  else VectorV[port] = z;
+}
+
+// Same as above with different argument type.
+void circuit::setV (int port, nr_double_t z) {
+  if (VectorVr) VectorVr[port] = z;
+  else VectorV[port] = z;
+}
+
+/* The function checks whether the circuit's terminal voltages moved
+   by less than the given tolerances since its last evaluation and
+   whether the terminal currents predicted by the linearisation at that
+   point changed by less than the tolerances as well.  In this case the
+   previously computed MNA entries are still valid and the evaluation
+   can be bypassed.  Otherwise the current voltages are remembered for
+   the next check. */
+bool circuit::checkBypass (nr_double_t reltol, nr_double_t abstol,
+			   nr_double_t vntol) {
+  if (VectorVB == NULL) return false;
+  bool bypass = RETFLAG (CIRCUIT_BYPASSVALID);
+  for (int i = 0; bypass && i < size; i++) {
+    nr_double_t v = real (getV (i)), u = VectorVB[i];
+    if (std::abs (v - u) > reltol * std::max (std::abs (v), std::abs (u)) +
+	vntol)
+      bypass = false;
+  }
+  for (int r = 0; bypass && r < size; r++) {
+    nr_double_t i = -real (getI (r)), di = 0;
+    for (int c = 0; c < size; c++) {
+      nr_double_t y = getG (r, c);
+      i  += y * VectorVB[c];
+      di += y * (real (getV (c)) - VectorVB[c]);
+    }
+    if (std::abs (di) > reltol * std::max (std::abs (i), std::abs (i + di)) +
+	abstol)
+      bypass = false;
+  }
+  if (!bypass) {
+    for (int i = 0; i < size; i++) VectorVB[i] = real (getV (i));
+    flag |= CIRCUIT_BYPASSVALID;
+  }
+  return bypass;
 }
 
 /* Returns the circuits G-MNA matrix value depending on the port
    numbers. */
 nr_complex_t circuit::getY (int r, int c) {
+  if (MatrixYr) return MatrixYr[r * size + c];
   return MatrixY[r * size + c];
 }
 
 /* Sets the circuits G-MNA matrix value depending on the port
    numbers. */
 void circuit::setY (int r, int c, nr_complex_t y) {
-  MatrixY[r * size + c] = y;
+  if (MatrixYr) MatrixYr[r * size + c] = real (y);
+  else MatrixY[r * size + c] = y;
+}
+
+/* Same as above with different argument type. */
+void circuit::setY (int r, int c, nr_double_t y) {
+  if (MatrixYr) MatrixYr[r * size + c] = y;
+  else MatrixY[r * size + c] = y;
 }
 
 /* Modifies the circuits G-MNA matrix value depending on the port
    numbers. */
 void circuit::addY (int r, int c, nr_complex_t y) {
-  MatrixY[r * size + c] += y;
+  if (MatrixYr) MatrixYr[r * size + c] += real (y);
+  else MatrixY[r * size + c] += y;
 }
 
 /* Same as above with different argument type. */
 void circuit::addY (int r, int c, nr_double_t y) {
-  MatrixY[r * size + c] += y;
+  if (MatrixYr) MatrixYr[r * size + c] += y;
+  else MatrixY[r * size + c] += y;
 }
 
 /* Returns the circuits G-MNA matrix value depending on the port
    numbers. */
 nr_double_t circuit::getG (int r, int c) {
+  if (MatrixYr) return MatrixYr[r * size + c];
   return real (MatrixY[r * size + c]);
 }
 
 /* Sets the circuits G-MNA matrix value depending on the port
    numbers. */
 void circuit::setG (int r, int c, nr_double_t y) {
-  MatrixY[r * size + c] = y;
+  if (MatrixYr) MatrixYr[r * size + c] = y;
+  else MatrixY[r * size + c] = y;
 }
 
 /* Returns the circuits C-HB matrix value depending on the port
@@ -688,7 +896,10 @@ void circuit::setMatrixY (matrix y) {
   int c = y.getCols ();
   // copy matrix elements
   if (r > 0 && c > 0 && r * c == size * size) {
-    memcpy (MatrixY, y.getData (), sizeof (nr_complex_t) * r * c);
+    if (MatrixYr) {
+      for (int i = 0; i < r * c; i++) MatrixYr[i] = real (y.getData ()[i]);
+    }
+    else memcpy (MatrixY, y.getData (), sizeof (nr_complex_t) * r * c);
   }
 }
 
@@ -698,48 +909,56 @@ matrix circuit::getMatrixY (void) {
   matrix res (size);
   for(unsigned int i=0; i < size; ++i)
     for(unsigned int j=0; j < size; ++j)
-      res(i,j) = MatrixY[i*size + j];
+      res(i,j) = getY (i, j);
   return res;
 }
 
 // The function cleans up the B-MNA matrix entries.
 void circuit::clearB (void) {
-  memset (MatrixB, 0, sizeof (nr_complex_t) * size * vsources);
+  if (MatrixBr) memset (MatrixBr, 0, sizeof (nr_double_t) * size * vsources);
+  else memset (MatrixB, 0, sizeof (nr_complex_t) * size * vsources);
 }
 
 // The function cleans up the C-MNA matrix entries.
 void circuit::clearC (void) {
-  memset (MatrixC, 0, sizeof (nr_complex_t) * size * vsources);
+  if (MatrixCr) memset (MatrixCr, 0, sizeof (nr_double_t) * size * vsources);
+  else memset (MatrixC, 0, sizeof (nr_complex_t) * size * vsources);
 }
 
 // The function cleans up the D-MNA matrix entries.
 void circuit::clearD (void) {
-  memset (MatrixD, 0, sizeof (nr_complex_t) * vsources * vsources);
+  if (MatrixDr) memset (MatrixDr, 0, sizeof (nr_double_t) * vsources * vsources);
+  else memset (MatrixD, 0, sizeof (nr_complex_t) * vsources * vsources);
 }
 
 // The function cleans up the E-MNA matrix entries.
 void circuit::clearE (void) {
-  memset (VectorE, 0, sizeof (nr_complex_t) * vsources);
+  if (VectorEr) memset (VectorEr, 0, sizeof (nr_double_t) * vsources);
+  else memset (VectorE, 0, sizeof (nr_complex_t) * vsources);
 }
 
 // The function cleans up the J-MNA matrix entries.
 void circuit::clearJ (void) {
-  memset (VectorJ, 0, sizeof (nr_complex_t) * vsources);
+  if (VectorJr) memset (VectorJr, 0, sizeof (nr_double_t) * vsources);
+  else memset (VectorJ, 0, sizeof (nr_complex_t) * vsources);
 }
 
 // The function cleans up the I-MNA matrix entries.
 void circuit::clearI (void) {
-  memset (VectorI, 0, sizeof (nr_complex_t) * size);
+  if (VectorIr) memset (VectorIr, 0, sizeof (nr_double_t) * size);
+  else memset (VectorI, 0, sizeof (nr_complex_t) * size);
 }
 
 // The function cleans up the V-MNA matrix entries.
 void circuit::clearV (void) {
-  memset (VectorV, 0, sizeof (nr_complex_t) * size);
+  if (VectorVr) memset (VectorVr, 0, sizeof (nr_double_t) * size);
+  else memset (VectorV, 0, sizeof (nr_complex_t) * size);
 }
 
 // The function cleans up the G-MNA matrix entries.
 void circuit::clearY (void) {
-  memset (MatrixY, 0, sizeof (nr_complex_t) * size * size);
+  if (MatrixYr) memset (MatrixYr, 0, sizeof (nr_double_t) * size * size);
+  else memset (MatrixY, 0, sizeof (nr_complex_t) * size * size);
 }
 
 /* This function can be used by several components in order to place
@@ -73,6 +73,11 @@ enum circuit_flag {
   CIRCUIT_VARSIZE     = 64,
   CIRCUIT_PROBE       = 128,
   CIRCUIT_HISTORY     = 256,
+  CIRCUIT_BYPASS      = 512,
+  CIRCUIT_BYPASSVALID = 1024,
+  CIRCUIT_CONCURRENT  = 2048,
+  CIRCUIT_REALMNA     = 4096,
+  CIRCUIT_VARMATRIX   = 8192,
 };
 
 class node;
@@ -133,6 +138,7 @@ class circuit : public object, public integrator
   virtual void calcAC (nr_double_t) { }
   virtual void initTR (void) { allocMatrixMNA (); }
   virtual void calcTR (nr_double_t) { }
+  virtual nr_double_t nextBreakpoint (nr_double_t) { return -1; }
   virtual void initHB (void) { allocMatrixMNA (); }
   virtual void calcHB (nr_double_t) { }
   virtual void initHB (int) { allocMatrixMNA (); }
@@ -280,6 +286,14 @@ class circuit : public object, public integrator
   void setV (int, nr_complex_t);
   void setQ (int, nr_complex_t);
   void setG (int, int, nr_double_t);
+  void setY (int, int, nr_double_t);
+  void setB (int, int, nr_double_t);
+  void setC (int, int, nr_double_t);
+  void setD (int, int, nr_double_t);
+  void setE (int, nr_double_t);
+  void setI (int, nr_double_t);
+  void setJ (int, nr_double_t);
+  void setV (int, nr_double_t);
   void clearB (void);
   void clearC (void);
   void clearD (void);
@@ -311,6 +325,20 @@ class circuit : public object, public integrator
   void setNonLinear (bool l) { MODFLAG (!l, CIRCUIT_LINEAR); }
   bool isNonLinear (void) { return !RETFLAG (CIRCUIT_LINEAR); }
 
+  // linear circuits whose matrix entries change during a solver run
+  void setVariableMatrix (bool v) { MODFLAG (v, CIRCUIT_VARMATRIX); }
+  bool isVariableMatrix (void) { return RETFLAG (CIRCUIT_VARMATRIX); }
+
+  // bypass of unchanged non-linear devices during the iterations
+  void setBypass (bool b) { MODFLAG (b, CIRCUIT_BYPASS); }
+  bool canBypass (void) { return RETFLAG (CIRCUIT_BYPASS); }
+  bool checkBypass (nr_double_t, nr_double_t, nr_double_t);
+  void clearBypass (void) { flag &= ~CIRCUIT_BYPASSVALID; }
+
+  // concurrent evaluation of self-contained devices
+  void setConcurrent (bool c) { MODFLAG (c, CIRCUIT_CONCURRENT); }
+  bool isConcurrent (void) { return RETFLAG (CIRCUIT_CONCURRENT); }
+
   // miscellaneous functionality
   void print (void);
   static std::string createInternal (const std::string &, const std::string &);
@@ -321,6 +349,8 @@ class circuit : public object, public integrator
   void   allocMatrixN (int sources = 0);
   void   allocMatrixMNA (void);
   void   freeMatrixMNA (void);
+  void   setRealMNA (bool);
+  bool   isRealMNA (void) { return RETFLAG (CIRCUIT_REALMNA); }
   void   allocMatrixHB (void);
   void   freeMatrixHB (void);
   void   setMatrixS (matrix);
@@ -358,6 +388,15 @@ class circuit : public object, public integrator
   nr_complex_t * MatrixQV;
   nr_complex_t * VectorGV;
   nr_complex_t * VectorCV;
+  nr_double_t * VectorVB;
+  nr_double_t * MatrixYr;
+  nr_double_t * MatrixBr;
+  nr_double_t * MatrixCr;
+  nr_double_t * MatrixDr;
+  nr_double_t * VectorEr;
+  nr_double_t * VectorIr;
+  nr_double_t * VectorVr;
+  nr_double_t * VectorJr;
   std::string subcircuit;
   node * nodes;
   substrate * subst;
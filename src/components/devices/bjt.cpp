@@ -43,6 +43,8 @@ using namespace qucs::device;
 bjt::bjt () : circuit (4) {
   cbcx = rb = re = rc = NULL;
   type = CIR_BJT;
+  setBypass (true);
+  setConcurrent (true);
 }
 
 void bjt::calcSP (nr_double_t frequency) {
@@ -344,6 +346,7 @@ void bjt::initDC (void) {
     rb->setProperty ("R", Rb);
     rb->setProperty ("Temp", T);
     rb->setProperty ("Controlled", getName ());
+    rb->setVariableMatrix (true); // modulated by the base current
     rb->initDC ();
   }
   // no series resistance at base
@@ -352,6 +355,48 @@ void bjt::initDC (void) {
     Rbb = 0.0;                 // set this operating point
     setProperty ("Xcjc", 1.0); // other than 1 is senseless here
   }
+
+  // resolve the parameters needed during the iterations
+  resolveParameters ();
+}
+
+/* Stores the (scaled) model parameters in plain fields, thus saving
+   the property lookups in each iteration. */
+void bjt::resolveParameters (void) {
+  par.Is   = getScaledProperty ("Is");
+  par.Nf   = getPropertyDouble ("Nf");
+  par.Nr   = getPropertyDouble ("Nr");
+  par.Vaf  = getPropertyDouble ("Vaf");
+  par.Var  = getPropertyDouble ("Var");
+  par.Ikf  = getScaledProperty ("Ikf");
+  par.Ikr  = getScaledProperty ("Ikr");
+  par.Bf   = getScaledProperty ("Bf");
+  par.Br   = getScaledProperty ("Br");
+  par.Ise  = getScaledProperty ("Ise");
+  par.Isc  = getScaledProperty ("Isc");
+  par.Ne   = getPropertyDouble ("Ne");
+  par.Nc   = getPropertyDouble ("Nc");
+  par.Rb   = getScaledProperty ("Rb");
+  par.Rbm  = getScaledProperty ("Rbm");
+  par.Irb  = getScaledProperty ("Irb");
+  par.T    = getPropertyDouble ("Temp");
+  par.Cje  = getScaledProperty ("Cje");
+  par.Vje  = getScaledProperty ("Vje");
+  par.Mje  = getPropertyDouble ("Mje");
+  par.Cjc  = getScaledProperty ("Cjc");
+  par.Vjc  = getScaledProperty ("Vjc");
+  par.Mjc  = getPropertyDouble ("Mjc");
+  par.Xcjc = getPropertyDouble ("Xcjc");
+  par.Cjs  = getScaledProperty ("Cjs");
+  par.Vjs  = getScaledProperty ("Vjs");
+  par.Mjs  = getPropertyDouble ("Mjs");
+  par.Fc   = getPropertyDouble ("Fc");
+  par.Vtf  = getPropertyDouble ("Vtf");
+  par.Tf   = getPropertyDouble ("Tf");
+  par.Xtf  = getPropertyDouble ("Xtf");
+  par.Itf  = getScaledProperty ("Itf");
+  par.Tr   = getPropertyDouble ("Tr");
+  par.Ptf  = getPropertyDouble ("Ptf");
 }
 
 void bjt::restartDC (void) {
@@ -365,23 +410,23 @@ void bjt::restartDC (void) {
 void bjt::calcDC (void) {
 
   // fetch device model parameters
-  nr_double_t Is   = getScaledProperty ("Is");
-  nr_double_t Nf   = getPropertyDouble ("Nf");
-  nr_double_t Nr   = getPropertyDouble ("Nr");
-  nr_double_t Vaf  = getPropertyDouble ("Vaf");
-  nr_double_t Var  = getPropertyDouble ("Var");
-  nr_double_t Ikf  = getScaledProperty ("Ikf");
-  nr_double_t Ikr  = getScaledProperty ("Ikr");
-  nr_double_t Bf   = getScaledProperty ("Bf");
-  nr_double_t Br   = getScaledProperty ("Br");
-  nr_double_t Ise  = getScaledProperty ("Ise");
-  nr_double_t Isc  = getScaledProperty ("Isc");
-  nr_double_t Ne   = getPropertyDouble ("Ne");
-  nr_double_t Nc   = getPropertyDouble ("Nc");
-  nr_double_t Rb   = getScaledProperty ("Rb");
-  nr_double_t Rbm  = getScaledProperty ("Rbm");
-  nr_double_t Irb  = getScaledProperty ("Irb");
-  nr_double_t T    = getPropertyDouble ("Temp");
+  nr_double_t Is   = par.Is;
+  nr_double_t Nf   = par.Nf;
+  nr_double_t Nr   = par.Nr;
+  nr_double_t Vaf  = par.Vaf;
+  nr_double_t Var  = par.Var;
+  nr_double_t Ikf  = par.Ikf;
+  nr_double_t Ikr  = par.Ikr;
+  nr_double_t Bf   = par.Bf;
+  nr_double_t Br   = par.Br;
+  nr_double_t Ise  = par.Ise;
+  nr_double_t Isc  = par.Isc;
+  nr_double_t Ne   = par.Ne;
+  nr_double_t Nc   = par.Nc;
+  nr_double_t Rb   = par.Rb;
+  nr_double_t Rbm  = par.Rbm;
+  nr_double_t Irb  = par.Irb;
+  nr_double_t T    = par.T;
 
   nr_double_t Ut, Q1, Q2;
   nr_double_t Iben, Ibcn, Ibei, Ibci, Ibc, gbe, gbc, gtiny;
@@ -580,22 +625,22 @@ void bjt::loadOperatingPoints (void) {
 void bjt::calcOperatingPoints (void) {
 
   // fetch device model parameters
-  nr_double_t Cje0 = getScaledProperty ("Cje");
-  nr_double_t Vje  = getScaledProperty ("Vje");
-  nr_double_t Mje  = getPropertyDouble ("Mje");
-  nr_double_t Cjc0 = getScaledProperty ("Cjc");
-  nr_double_t Vjc  = getScaledProperty ("Vjc");
-  nr_double_t Mjc  = getPropertyDouble ("Mjc");
-  nr_double_t Xcjc = getPropertyDouble ("Xcjc");
-  nr_double_t Cjs0 = getScaledProperty ("Cjs");
-  nr_double_t Vjs  = getScaledProperty ("Vjs");
-  nr_double_t Mjs  = getPropertyDouble ("Mjs");
-  nr_double_t Fc   = getPropertyDouble ("Fc");
-  nr_double_t Vtf  = getPropertyDouble ("Vtf");
-  nr_double_t Tf   = getPropertyDouble ("Tf");
-  nr_double_t Xtf  = getPropertyDouble ("Xtf");
-  nr_double_t Itf  = getScaledProperty ("Itf");
-  nr_double_t Tr   = getPropertyDouble ("Tr");
+  nr_double_t Cje0 = par.Cje;
+  nr_double_t Vje  = par.Vje;
+  nr_double_t Mje  = par.Mje;
+  nr_double_t Cjc0 = par.Cjc;
+  nr_double_t Vjc  = par.Vjc;
+  nr_double_t Mjc  = par.Mjc;
+  nr_double_t Xcjc = par.Xcjc;
+  nr_double_t Cjs0 = par.Cjs;
+  nr_double_t Vjs  = par.Vjs;
+  nr_double_t Mjs  = par.Mjs;
+  nr_double_t Fc   = par.Fc;
+  nr_double_t Vtf  = par.Vtf;
+  nr_double_t Tf   = par.Tf;
+  nr_double_t Xtf  = par.Xtf;
+  nr_double_t Itf  = par.Itf;
+  nr_double_t Tr   = par.Tr;
 
   nr_double_t Cbe, Cbci, Cbcx, Ccs;
 
@@ -747,8 +792,8 @@ void bjt::calcTR (nr_double_t t) {
 void bjt::excessPhase (int istate, nr_double_t& i, nr_double_t& g) {
 
   // fetch device properties
-  nr_double_t Ptf = getPropertyDouble ("Ptf");
-  nr_double_t Tf = getPropertyDouble ("Tf");
+  nr_double_t Ptf = par.Ptf;
+  nr_double_t Tf = par.Tf;
   nr_double_t td = deg2rad (Ptf) * Tf;
 
   // return if nothing todo
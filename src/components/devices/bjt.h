@@ -50,6 +50,7 @@ class bjt : public qucs::circuit
   qucs::matrix calcMatrixY (nr_double_t);
   qucs::matrix calcMatrixCy (nr_double_t);
   void excessPhase (int, nr_double_t&, nr_double_t&);
+  void resolveParameters (void);
 
  private:
   nr_double_t Ucs, Ubx, Ube, Ubc, Uce, UbePrev, UbcPrev;
@@ -61,6 +62,14 @@ class bjt : public qucs::circuit
   nr_double_t gbei, gben, gbci, gbcn, gitf, gitr, gif, gir, Rbb, Ibe;
   nr_double_t Qbe, Qbci, Qbcx, Qcs;
   bool doTR;
+
+  // resolved model parameters used during the iterations
+  struct parameters {
+    nr_double_t Is, Nf, Nr, Vaf, Var, Ikf, Ikr, Bf, Br, Ise, Isc;
+    nr_double_t Ne, Nc, Rb, Rbm, Irb, T;
+    nr_double_t Cje, Vje, Mje, Cjc, Vjc, Mjc, Xcjc, Cjs, Vjs, Mjs;
+    nr_double_t Fc, Vtf, Tf, Xtf, Itf, Tr, Ptf;
+  } par;
 };
 
 #endif /* __BJT_H__ */
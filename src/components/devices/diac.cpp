@@ -42,6 +42,8 @@ using namespace qucs::device;
 // Constructor for the diac.
 diac::diac () : circuit (3) {
   type = CIR_DIAC;
+  setBypass (true);
+  setConcurrent (true);
 }
 
 // Callback for initializing the DC analysis.
@@ -49,6 +49,8 @@ using namespace qucs::device;
 diode::diode () : circuit (2) {
   rs = NULL;
   type = CIR_DIODE;
+  setBypass (true);
+  setConcurrent (true);
 }
 
 // Callback for S-parameter analysis.
@@ -184,6 +186,23 @@ void diode::initModel (void) {
   setScaledProperty ("Rs", Rs / A);
 }
 
+/* Stores the (scaled) model parameters in plain fields, thus saving
+   the property lookups in each iteration. */
+void diode::resolveParameters (void) {
+  par.Is  = getScaledProperty ("Is");
+  par.N   = getPropertyDouble ("N");
+  par.Isr = getScaledProperty ("Isr");
+  par.Nr  = getPropertyDouble ("Nr");
+  par.Ikf = getPropertyDouble ("Ikf");
+  par.T   = getPropertyDouble ("Temp");
+  par.M   = getScaledProperty ("M");
+  par.Cj0 = getScaledProperty ("Cj0");
+  par.Vj  = getScaledProperty ("Vj");
+  par.Fc  = getPropertyDouble ("Fc");
+  par.Cp  = getPropertyDouble ("Cp");
+  par.Tt  = getScaledProperty ("Tt");
+}
+
 // Prepares DC (i.e. HB) analysis.
 void diode::prepareDC (void) {
   // allocate MNA matrices
@@ -251,6 +270,9 @@ void diode::prepareDC (void) {
       }
     }
   }
+
+  // resolve the parameters needed during the iterations
+  resolveParameters ();
 }
 
 // Callback for initializing the DC analysis.
@@ -269,12 +291,12 @@ void diode::restartDC (void) {
 // Callback for DC analysis.
 void diode::calcDC (void) {
   // get device properties
-  nr_double_t Is  = getScaledProperty ("Is");
-  nr_double_t N   = getPropertyDouble ("N");
-  nr_double_t Isr = getScaledProperty ("Isr");
-  nr_double_t Nr  = getPropertyDouble ("Nr");
-  nr_double_t Ikf = getPropertyDouble ("Ikf");
-  nr_double_t T   = getPropertyDouble ("Temp");
+  nr_double_t Is  = par.Is;
+  nr_double_t N   = par.N;
+  nr_double_t Isr = par.Isr;
+  nr_double_t Nr  = par.Nr;
+  nr_double_t Ikf = par.Ikf;
+  nr_double_t T   = par.T;
 
   nr_double_t Ut, Ieq, Ucrit, gtiny;
 
@@ -361,12 +383,12 @@ void diode::calcOperatingPoints (void) {
   loadOperatingPoints ();
 
   // get necessary properties
-  nr_double_t M   = getScaledProperty ("M");
-  nr_double_t Cj0 = getScaledProperty ("Cj0");
-  nr_double_t Vj  = getScaledProperty ("Vj");
-  nr_double_t Fc  = getPropertyDouble ("Fc");
-  nr_double_t Cp  = getPropertyDouble ("Cp");
-  nr_double_t Tt  = getScaledProperty ("Tt");
+  nr_double_t M   = par.M;
+  nr_double_t Cj0 = par.Cj0;
+  nr_double_t Vj  = par.Vj;
+  nr_double_t Fc  = par.Fc;
+  nr_double_t Cp  = par.Cp;
+  nr_double_t Tt  = par.Tt;
 
   // calculate capacitances and charges
   nr_double_t Cd;
@@ -52,10 +52,17 @@ class diode : public qucs::circuit, public qucs::devstates
   qucs::circuit * rs;
   bool doHB;
 
+  // resolved model parameters used during the iterations
+  struct parameters {
+    nr_double_t Is, N, Isr, Nr, Ikf, T;
+    nr_double_t M, Cj0, Vj, Fc, Cp, Tt;
+  } par;
+
  private:
   qucs::matrix calcMatrixCy (nr_double_t);
   void prepareDC (void);
   void initModel (void);
+  void resolveParameters (void);
 };
 
 #endif /* __DIODE_H__ */
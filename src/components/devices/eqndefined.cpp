@@ -30,6 +30,7 @@
 #include "equation.h"
 #include "environment.h"
 #include "device.h"
+#include "tape.h"
 #include "eqndefined.h"
 
 using namespace qucs;
@@ -44,6 +45,11 @@ eqndefined::eqndefined () : circuit () {
   qeqn = NULL;
   geqn = NULL;
   ceqn = NULL;
+  itape = NULL;
+  gtape = NULL;
+  qtape = NULL;
+  ctape = NULL;
+  doSolve = true;
   _jstat = NULL;
   _jdyna = NULL;
   _charges = NULL;
@@ -56,6 +62,10 @@ eqndefined::~eqndefined () {
   free (geqn);
   free (qeqn);
   free (ceqn);
+  delete[] itape;
+  delete[] gtape;
+  delete[] qtape;
+  delete[] ctape;
   free (_jstat);
   free (_jdyna);
   free (_charges);
@@ -110,12 +120,6 @@ void eqndefined::setResult (void * eqn, nr_double_t val) {
   c->d = val;
 }
 
-// Returns the result of the equation.
-nr_double_t eqndefined::getResult (void * eqn) {
-  A(eqn)->evaluate ();
-  return A(eqn)->getResultDouble ();
-}
-
 // Initializes the equation defined device.
 void eqndefined::initModel (void) {
   int i, j, k, branches = getSize () / 2;
@@ -263,6 +267,43 @@ void eqndefined::initModel (void) {
       free (vn);
     }
   }
+
+  // finally compile the equations
+  initTapes ();
+}
+
+/* Compiles the current, charge and derivative equations into tapes.
+   These are evaluated in each iteration without going through the
+   equation tree. */
+void eqndefined::initTapes (void) {
+  int i, k, branches = getSize () / 2;
+  eqn::solver * solvee = getEnv()->getSolver ();
+
+  itape = new tape[branches];
+  qtape = new tape[branches];
+  gtape = new tape[branches * branches];
+  ctape = new tape[branches * branches];
+  for (k = 0, i = 0; i < branches; i++) {
+    if (ieqn[i]) A(ieqn[i])->solvee = solvee;
+    if (qeqn[i]) A(qeqn[i])->solvee = solvee;
+    itape[i].compile (A(ieqn[i]));
+    qtape[i].compile (A(qeqn[i]));
+    for (int j = 0; j < branches; j++, k++) {
+      if (geqn[k]) A(geqn[k])->solvee = solvee;
+      if (ceqn[k]) A(ceqn[k])->solvee = solvee;
+      gtape[k].compile (A(geqn[k]));
+      ctape[k].compile (A(ceqn[k]));
+    }
+  }
+
+  /* the equation solver needs to be run in each iteration only if one
+     of the tapes reads results of the local subcircuit equations */
+  doSolve = false;
+  for (k = 0, i = 0; i < branches; i++) {
+    doSolve |= itape[i].needsSolver () || qtape[i].needsSolver ();
+    for (int j = 0; j < branches; j++, k++)
+      doSolve |= gtape[k].needsSolver () || ctape[k].needsSolver ();
+  }
 }
 
 // Update local variable equations.
@@ -275,7 +316,7 @@ void eqndefined::updateLocals (void) {
   }
   // get local subcircuit values
   getEnv()->passConstants ();
-  getEnv()->equationSolver ();
+  if (doSolve) getEnv()->equationSolver ();
 }
 
 // Callback for DC analysis.
@@ -287,7 +328,7 @@ void eqndefined::calcDC (void) {
 
   // calculate currents and put into right-hand side
   for (i = 0; i < branches; i++) {
-    nr_double_t c = getResult (ieqn[i]);
+    nr_double_t c = itape[i].evalDouble ();
     setI (i * 2 + 0, -c);
     setI (i * 2 + 1, +c);
   }
@@ -297,7 +338,7 @@ void eqndefined::calcDC (void) {
     nr_double_t gv = 0;
     // usual G (dI/dV) entries
     for (j = 0; j < branches; j++, k++) {
-      nr_double_t g = getResult (geqn[k]);
+      nr_double_t g = gtape[k].evalDouble ();
       setY (i * 2 + 0, j * 2 + 0, +g);
       setY (i * 2 + 1, j * 2 + 1, +g);
       setY (i * 2 + 0, j * 2 + 1, -g);
@@ -323,12 +364,12 @@ void eqndefined::evalOperatingPoints (void) {
 
   // save values for charges, conductances and capacitances
   for (k = 0, i = 0; i < branches; i++) {
-    nr_double_t q = getResult (qeqn[i]);
+    nr_double_t q = qtape[i].evalDouble ();
     _charges[i] = q;
     for (j = 0; j < branches; j++, k++) {
-      nr_double_t g = getResult (geqn[k]);
+      nr_double_t g = gtape[k].evalDouble ();
       _jstat[k] = g;
-      nr_double_t c = getResult (ceqn[k]);
+      nr_double_t c = ctape[k].evalDouble ();
       _jdyna[k] = c;
     }
   }
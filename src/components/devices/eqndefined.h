@@ -25,6 +25,12 @@
 #ifndef __EQNDEFINED_H__
 #define __EQNDEFINED_H__
 
+namespace qucs {
+  namespace eqn {
+    class tape;
+  }
+}
+
 class eqndefined : public qucs::circuit
 {
  public:
@@ -44,10 +50,10 @@ class eqndefined : public qucs::circuit
 
  private:
   void initModel (void);
+  void initTapes (void);
   char * createVariable (const char *, int, int, bool prefix = true);
   char * createVariable (const char *, int, bool prefix = true);
   void setResult (void *, nr_double_t);
-  nr_double_t getResult (void *);
   qucs::matrix calcMatrixY (nr_double_t);
   void evalOperatingPoints (void);
   void updateLocals (void);
@@ -58,10 +64,15 @@ class eqndefined : public qucs::circuit
   void ** geqn;
   void ** qeqn;
   void ** ceqn;
+  qucs::eqn::tape * itape;
+  qucs::eqn::tape * gtape;
+  qucs::eqn::tape * qtape;
+  qucs::eqn::tape * ctape;
   nr_double_t * _jstat;
   nr_double_t * _jdyna;
   nr_double_t * _charges;
   bool doHB;
+  bool doSolve;
 };
 
 #endif /* __EQNDEFINED_H__ */
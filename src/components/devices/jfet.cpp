@@ -40,6 +40,8 @@ using namespace qucs::device;
 jfet::jfet () : circuit (3) {
   rs = rd = NULL;
   type = CIR_JFET;
+  setBypass (true);
+  setConcurrent (true);
 }
 
 void jfet::calcSP (nr_double_t frequency) {
@@ -214,19 +216,40 @@ void jfet::initDC (void) {
   else {
     disableResistor (this, rd, NODE_D);
   }
+
+  // resolve the parameters needed during the iterations
+  resolveParameters ();
+}
+
+/* Stores the (scaled) model parameters in plain fields, thus saving
+   the property lookups in each iteration. */
+void jfet::resolveParameters (void) {
+  par.Is     = getScaledProperty ("Is");
+  par.N      = getPropertyDouble ("N");
+  par.Isr    = getScaledProperty ("Isr");
+  par.Nr     = getPropertyDouble ("Nr");
+  par.Vt0    = getScaledProperty ("Vt0");
+  par.Lambda = getPropertyDouble ("Lambda");
+  par.Beta   = getScaledProperty ("Beta");
+  par.T      = getPropertyDouble ("Temp");
+  par.M      = getPropertyDouble ("M");
+  par.Cgd    = getScaledProperty ("Cgd");
+  par.Cgs    = getScaledProperty ("Cgs");
+  par.Pb     = getScaledProperty ("Pb");
+  par.Fc     = getPropertyDouble ("Fc");
 }
 
 void jfet::calcDC (void) {
 
   // fetch device model parameters
-  nr_double_t Is   = getScaledProperty ("Is");
-  nr_double_t n    = getPropertyDouble ("N");
-  nr_double_t Isr  = getScaledProperty ("Isr");
-  nr_double_t nr   = getPropertyDouble ("Nr");
-  nr_double_t Vt0  = getScaledProperty ("Vt0");
-  nr_double_t l    = getPropertyDouble ("Lambda");
-  nr_double_t beta = getScaledProperty ("Beta");
-  nr_double_t T    = getPropertyDouble ("Temp");
+  nr_double_t Is   = par.Is;
+  nr_double_t n    = par.N;
+  nr_double_t Isr  = par.Isr;
+  nr_double_t nr   = par.Nr;
+  nr_double_t Vt0  = par.Vt0;
+  nr_double_t l    = par.Lambda;
+  nr_double_t beta = par.Beta;
+  nr_double_t T    = par.T;
 
   nr_double_t Ut, IeqG, IeqD, IeqS, UgsCrit, UgdCrit;
   nr_double_t Igs, Igd, gtiny;
@@ -347,11 +370,11 @@ void jfet::saveOperatingPoints (void) {
 void jfet::calcOperatingPoints (void) {
 
   // fetch device model parameters
-  nr_double_t z    = getPropertyDouble ("M");
-  nr_double_t Cgd0 = getScaledProperty ("Cgd");
-  nr_double_t Cgs0 = getScaledProperty ("Cgs");
-  nr_double_t Pb   = getScaledProperty ("Pb");
-  nr_double_t Fc   = getPropertyDouble ("Fc");
+  nr_double_t z    = par.M;
+  nr_double_t Cgd0 = par.Cgd;
+  nr_double_t Cgs0 = par.Cgs;
+  nr_double_t Pb   = par.Pb;
+  nr_double_t Fc   = par.Fc;
 
   nr_double_t Cgs, Cgd;
 
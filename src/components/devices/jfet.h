@@ -47,12 +47,19 @@ class jfet : public qucs::circuit
   qucs::matrix calcMatrixY (nr_double_t);
   qucs::matrix calcMatrixCy (nr_double_t);
   void initModel (void);
+  void resolveParameters (void);
 
  private:
   nr_double_t Ugs, Ugd, Uds, UgsPrev, UgdPrev;
   nr_double_t ggs, ggd, gm, gds, Ids, Qgs, Qgd;
   qucs::circuit * rs;
   qucs::circuit * rd;
+
+  // resolved model parameters used during the iterations
+  struct parameters {
+    nr_double_t Is, N, Isr, Nr, Vt0, Lambda, Beta, T;
+    nr_double_t M, Cgd, Cgs, Pb, Fc;
+  } par;
 };
 
 #endif /* __JFET_H__ */
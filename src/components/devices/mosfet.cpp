@@ -42,6 +42,8 @@ mosfet::mosfet () : circuit (4) {
   transientMode = 0;
   rg = rs = rd = NULL;
   type = CIR_MOSFET;
+  setBypass (true);
+  setConcurrent (true);
 }
 
 void mosfet::calcSP (nr_double_t frequency) {
@@ -185,6 +187,9 @@ void mosfet::initDC (void) {
   else {
     disableResistor (this, rd, NODE_D);
   }
+
+  // resolve the parameters needed during the iterations
+  resolveParameters ();
 }
 
 void mosfet::initModel (void) {
@@ -376,14 +381,38 @@ void mosfet::initModel (void) {
 #endif /* DEBUG */
 }
 
+/* Stores the (scaled) model parameters in plain fields, thus saving
+   the property lookups in each iteration. */
+void mosfet::resolveParameters (void) {
+  par.Isd      = getPropertyDouble ("Isd");
+  par.Iss      = getPropertyDouble ("Iss");
+  par.N        = getPropertyDouble ("N");
+  par.Lambda   = getPropertyDouble ("Lambda");
+  par.T        = getPropertyDouble ("Temp");
+  par.Cbd      = getScaledProperty ("Cbd");
+  par.Cbs      = getScaledProperty ("Cbs");
+  par.Cbds     = getPropertyDouble ("Cbds");
+  par.Cbss     = getPropertyDouble ("Cbss");
+  par.Cgso     = getPropertyDouble ("Cgso");
+  par.Cgdo     = getPropertyDouble ("Cgdo");
+  par.Cgbo     = getPropertyDouble ("Cgbo");
+  par.Pb       = getScaledProperty ("Pb");
+  par.Mj       = getPropertyDouble ("Mj");
+  par.Mjsw     = getPropertyDouble ("Mjsw");
+  par.Fc       = getPropertyDouble ("Fc");
+  par.Tt       = getPropertyDouble ("Tt");
+  par.W        = getPropertyDouble ("W");
+  par.capModel = getPropertyInteger ("capModel");
+}
+
 void mosfet::calcDC (void) {
 
   // fetch device model parameters
-  nr_double_t Isd = getPropertyDouble ("Isd");
-  nr_double_t Iss = getPropertyDouble ("Iss");
-  nr_double_t n   = getPropertyDouble ("N");
-  nr_double_t l   = getPropertyDouble ("Lambda");
-  nr_double_t T   = getPropertyDouble ("Temp");
+  nr_double_t Isd = par.Isd;
+  nr_double_t Iss = par.Iss;
+  nr_double_t n   = par.N;
+  nr_double_t l   = par.Lambda;
+  nr_double_t T   = par.T;
 
   nr_double_t Ut, IeqBS, IeqBD, IeqDS, UbsCrit, UbdCrit, gtiny;
 
@@ -566,19 +595,19 @@ void mosfet::loadOperatingPoints (void) {
 void mosfet::calcOperatingPoints (void) {
 
   // fetch device model parameters
-  nr_double_t Cbd0 = getScaledProperty ("Cbd");
-  nr_double_t Cbs0 = getScaledProperty ("Cbs");
-  nr_double_t Cbds = getPropertyDouble ("Cbds");
-  nr_double_t Cbss = getPropertyDouble ("Cbss");
-  nr_double_t Cgso = getPropertyDouble ("Cgso");
-  nr_double_t Cgdo = getPropertyDouble ("Cgdo");
-  nr_double_t Cgbo = getPropertyDouble ("Cgbo");
-  nr_double_t Pb   = getScaledProperty ("Pb");
-  nr_double_t M    = getPropertyDouble ("Mj");
-  nr_double_t Ms   = getPropertyDouble ("Mjsw");
-  nr_double_t Fc   = getPropertyDouble ("Fc");
-  nr_double_t Tt   = getPropertyDouble ("Tt");
-  nr_double_t W    = getPropertyDouble ("W");
+  nr_double_t Cbd0 = par.Cbd;
+  nr_double_t Cbs0 = par.Cbs;
+  nr_double_t Cbds = par.Cbds;
+  nr_double_t Cbss = par.Cbss;
+  nr_double_t Cgso = par.Cgso;
+  nr_double_t Cgdo = par.Cgdo;
+  nr_double_t Cgbo = par.Cgbo;
+  nr_double_t Pb   = par.Pb;
+  nr_double_t M    = par.Mj;
+  nr_double_t Ms   = par.Mjsw;
+  nr_double_t Fc   = par.Fc;
+  nr_double_t Tt   = par.Tt;
+  nr_double_t W    = par.W;
 
   nr_double_t Cbs, Cbd, Cgd, Cgb, Cgs;
 
@@ -659,7 +688,7 @@ void mosfet::initTR (void) {
 
 void mosfet::calcTR (nr_double_t) {
   calcDC ();
-  transientMode = getPropertyInteger ("capModel");
+  transientMode = par.capModel;
   saveOperatingPoints ();
   loadOperatingPoints ();
   calcOperatingPoints ();
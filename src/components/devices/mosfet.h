@@ -49,6 +49,7 @@ class mosfet : public qucs::circuit
   nr_double_t transientChargeSR (int, nr_double_t&, nr_double_t, nr_double_t);
   qucs::matrix calcMatrixY (nr_double_t);
   qucs::matrix calcMatrixCy (nr_double_t);
+  void resolveParameters (void);
 
  private:
   nr_double_t UbsPrev, UbdPrev, UgsPrev, UgdPrev, UdsPrev, Udsat, Uon;
@@ -60,6 +61,14 @@ class mosfet : public qucs::circuit
   qucs::circuit * rs;
   qucs::circuit * rd;
   qucs::circuit * rg;
+
+  // resolved model parameters used during the iterations
+  struct parameters {
+    nr_double_t Isd, Iss, N, Lambda, T;
+    nr_double_t Cbd, Cbs, Cbds, Cbss, Cgso, Cgdo, Cgbo;
+    nr_double_t Pb, Mj, Mjsw, Fc, Tt, W;
+    int capModel;
+  } par;
 };
 
 #endif /* __MOSFET_H__ */
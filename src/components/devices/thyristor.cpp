@@ -43,6 +43,8 @@ using namespace qucs::device;
 // Constructor for the thyristor.
 thyristor::thyristor () : circuit (4) {
   type = CIR_THYRISTOR;
+  setBypass (true);
+  setConcurrent (true);
 }
 
 // Callback for initializing the DC analysis.
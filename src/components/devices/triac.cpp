@@ -43,6 +43,8 @@ using namespace qucs::device;
 // Constructor for the triac.
 triac::triac () : circuit (4) {
   type = CIR_TRIAC;
+  setBypass (true);
+  setConcurrent (true);
 }
 
 // Callback for initializing the DC analysis.
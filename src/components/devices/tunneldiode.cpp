@@ -40,6 +40,8 @@ using namespace qucs::device;
 // Constructor for the diode.
 tunneldiode::tunneldiode () : circuit (2) {
   type = CIR_TUNNELDIODE;
+  setBypass (true);
+  setConcurrent (true);
 }
 
 // Callback for initializing the DC analysis.
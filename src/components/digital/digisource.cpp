@@ -80,6 +80,24 @@ void digisource::calcTR (nr_double_t t) {
   setE (VSRC_1, lo ? 0 : v);
 }
 
+/* Returns the first switching time of the periodic bit sequence after
+   the given time. */
+nr_double_t digisource::nextBreakpoint (nr_double_t t) {
+  qucs::vector * values = getPropertyVector ("times");
+  if (T <= 0) return -1;
+  nr_double_t n = qucs::floor (t / T);
+  // look into the current and the next period
+  for (int k = 0; k < 2; k++) {
+    nr_double_t ti = (n + k) * T;
+    if (ti > t) return ti;
+    for (int i = 0; i < values->getSize (); i++) {
+      ti += real (values->get (i));
+      if (ti > t) return ti;
+    }
+  }
+  return -1;
+}
+
 // properties
 PROP_REQ [] = {
   { "init", PROP_STR, { PROP_NO_VAL, "low" }, PROP_RNG_STR2 ("low", "high") },
@@ -84,6 +84,16 @@ void iexp::calcTR (nr_double_t t) {
   setI (NODE_1, +it * s); setI (NODE_2, -it * s);
 }
 
+/* Returns the first corner of the exponential pulse after the given
+   time or a negative value if there is none. */
+nr_double_t iexp::nextBreakpoint (nr_double_t t) {
+  nr_double_t t1 = getPropertyDouble ("T1");
+  nr_double_t t2 = getPropertyDouble ("T2");
+  if (t1 > t) return t1;
+  if (t2 > t) return t2;
+  return -1;
+}
+
 // properties
 PROP_REQ [] = {
   { "I1", PROP_REAL, { 0, PROP_NO_STR }, PROP_NO_RANGE },
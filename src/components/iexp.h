@@ -35,6 +35,7 @@ class iexp : public qucs::circuit
   void initAC (void);
   void initTR (void);
   void calcTR (nr_double_t);
+  nr_double_t nextBreakpoint (nr_double_t);
 };
 
 #endif /* __IEXP_H__ */
@@ -95,6 +95,33 @@ void irect::calcTR (nr_double_t t) {
   setI (NODE_1, +it * s); setI (NODE_2, -it * s);
 }
 
+/* Returns the first corner of the rectangular pulse train after the
+   given time. */
+nr_double_t irect::nextBreakpoint (nr_double_t t) {
+  nr_double_t th = getPropertyDouble ("TH");
+  nr_double_t tl = getPropertyDouble ("TL");
+  nr_double_t tr = getPropertyDouble ("Tr");
+  nr_double_t tf = getPropertyDouble ("Tf");
+  nr_double_t td = getPropertyDouble ("Td");
+  nr_double_t p = th + tl;
+
+  if (tr > th) tr = th;
+  if (tf > tl) tf = tl;
+
+  if (t < td) return td;
+  if (p <= 0) return -1;
+  nr_double_t bp[4] = { 0, tr, th, th + tf };
+  nr_double_t n = qucs::floor ((t - td) / p);
+  // look into the current and the next period
+  for (int k = 0; k < 2; k++) {
+    for (int i = 0; i < 4; i++) {
+      nr_double_t b = td + (n + k) * p + bp[i];
+      if (b > t) return b;
+    }
+  }
+  return -1;
+}
+
 // properties
 PROP_REQ [] = {
   { "I", PROP_REAL, { 1e-3, PROP_NO_STR }, PROP_NO_RANGE },
@@ -29,6 +29,7 @@
 #include "component.h"
 #include "equation.h"
 #include "environment.h"
+#include "tape.h"
 #include "rfedd.h"
 
 using namespace qucs;
@@ -39,11 +40,14 @@ rfedd::rfedd () : circuit () {
   type = CIR_RFEDD;
   setVariableSized (true);
   peqn = NULL;
+  ptape = NULL;
+  doSolve = true;
 }
 
 // Destructor deletes equation defined RF device object from memory.
 rfedd::~rfedd () {
   free (peqn);
+  delete[] ptape;
 }
 
 // Callback for initializing the DC analysis.
@@ -130,12 +134,6 @@ void rfedd::setResult (void * eqn, nr_complex_t val) {
   *(c->c) = val;
 }
 
-// Returns the result of the equation.
-nr_complex_t rfedd::getResult (void * eqn) {
-  A(eqn)->evaluate ();
-  return A(eqn)->getResultComplex ();
-}
-
 // Initializes the equation defined device.
 void rfedd::initModel (void) {
   int i, j, k, ports = getSize ();
@@ -145,6 +143,7 @@ void rfedd::initModel (void) {
 
   // allocate space for equation pointers
   peqn = (void **) malloc (sizeof (assignment *) * ports * ports);
+  ptape = new tape[ports * ports];
 
   // first create frequency variables
   sn = createVariable ("S");
@@ -184,6 +183,19 @@ void rfedd::initModel (void) {
     }
   }
 
+  // compile the parameter equations
+  for (k = 0; k < ports * ports; k++) {
+    if (peqn[k]) {
+      A(peqn[k])->solvee = getEnv()->getSolver ();
+      ptape[k].compile (A(peqn[k]));
+    }
+  }
+
+  // run the equation solver only if the tapes depend on it
+  doSolve = false;
+  for (k = 0; k < ports * ports; k++)
+    doSolve |= ptape[k].needsSolver ();
+
   free (sn); free (snold);
   free (fn); free (fnold);
 }
@@ -202,7 +214,7 @@ void rfedd::updateLocals (nr_double_t frequency) {
 
   // get local subcircuit values
   getEnv()->passConstants ();
-  getEnv()->equationSolver ();
+  if (doSolve) getEnv()->equationSolver ();
 }
 
 // Callback for DC analysis.
@@ -325,7 +337,7 @@ matrix rfedd::calcMatrix (nr_double_t frequency) {
   // calculate parameters and put into Jacobian
   for (k = 0, i = 0; i < ports; i++) {
     for (j = 0; j < ports; j++, k++) {
-      p (i, j) = getResult (peqn[k]);
+      p (i, j) = ptape[k].evalComplex ();
     }
   }
 
@@ -25,6 +25,12 @@
 #ifndef __RFEDD_H__
 #define __RFEDD_H__
 
+namespace qucs {
+  namespace eqn {
+    class tape;
+  }
+}
+
 class rfedd : public qucs::circuit
 {
  public:
@@ -45,7 +51,6 @@ class rfedd : public qucs::circuit
   char * createVariable (const char *, bool prefix = true);
   void setResult (void *, nr_double_t);
   void setResult (void *, nr_complex_t);
-  nr_complex_t getResult (void *);
   qucs::matrix calcMatrix (nr_double_t);
   void updateLocals (nr_double_t);
   void prepareModel (void);
@@ -54,6 +59,8 @@ class rfedd : public qucs::circuit
 
  private:
   void ** peqn;
+  qucs::eqn::tape * ptape;
+  bool doSolve;
   void * seqn;
   void * feqn;
 };
@@ -45,6 +45,7 @@ using namespace qucs;
 tswitch::tswitch () : circuit (2) {
   type = CIR_TSWITCH;
   setVoltageSources (1);
+  setVariableMatrix (true); // resistance changes in time
 }
 
 nr_double_t tswitch::initState (void) {
@@ -199,6 +200,25 @@ void tswitch::calcTR (nr_double_t t) {
   setD (VSRC_1, VSRC_1, -r);
 }
 
+/* Returns the first switching time after the given time, or the end
+   of the transition for smooth transitions, or a negative value if
+   there is none. */
+nr_double_t tswitch::nextBreakpoint (nr_double_t t) {
+  qucs::vector * values = getPropertyVector ("time");
+  bool abrupt = !strcmp (getPropertyString ("Transition"), "abrupt");
+  nr_double_t n = (repeat && T > 0) ? qucs::floor (t / T) : 0;
+  // look into the current and the next period of repeated patterns
+  for (int k = 0; k < (repeat ? 2 : 1); k++) {
+    nr_double_t ti = (n + k) * T;
+    for (int i = 0; i < values->getSize (); i++) {
+      ti += real (values->get (i));
+      if (ti > t) return ti;
+      if (!abrupt && ti + duration > t) return ti + duration;
+    }
+  }
+  return -1;
+}
+
 // properties
 PROP_REQ [] = {
   { "init", PROP_STR, { PROP_NO_VAL, "off" }, PROP_RNG_STR2 ("on", "off") },
@@ -35,6 +35,7 @@ vam::vam () : circuit (3) {
   type = CIR_VAM;
   setVSource (true);
   setVoltageSources (1);
+  setVariableMatrix (true); // modulation changes in time
 }
 
 void vam::initSP (void) {
@@ -85,6 +85,16 @@ void vexp::calcTR (nr_double_t t) {
   setE (VSRC_1, ut * s);
 }
 
+/* Returns the first corner of the exponential pulse after the given
+   time or a negative value if there is none. */
+nr_double_t vexp::nextBreakpoint (nr_double_t t) {
+  nr_double_t t1 = getPropertyDouble ("T1");
+  nr_double_t t2 = getPropertyDouble ("T2");
+  if (t1 > t) return t1;
+  if (t2 > t) return t2;
+  return -1;
+}
+
 // properties
 PROP_REQ [] = {
   { "U1", PROP_REAL, { 0, PROP_NO_STR }, PROP_NO_RANGE },
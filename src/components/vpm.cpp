@@ -35,6 +35,7 @@ vpm::vpm () : circuit (3) {
   type = CIR_VPM;
   setVSource (true);
   setVoltageSources (1);
+  setVariableMatrix (true); // modulation depends on time and voltage
 }
 
 void vpm::initSP (void) {
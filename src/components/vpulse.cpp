@@ -88,6 +88,21 @@ void vpulse::calcTR (nr_double_t t) {
   setE (VSRC_1, ut * s);
 }
 
+/* Returns the first corner of the pulse after the given time or a
+   negative value if there is none. */
+nr_double_t vpulse::nextBreakpoint (nr_double_t t) {
+  nr_double_t t1 = getPropertyDouble ("T1");
+  nr_double_t t2 = getPropertyDouble ("T2");
+  nr_double_t tr = getPropertyDouble ("Tr");
+  nr_double_t tf = getPropertyDouble ("Tf");
+  nr_double_t bp[4] = { t1, t1 + tr, t2 - tf, t2 };
+  nr_double_t next = -1;
+  for (int i = 0; i < 4; i++) {
+    if (bp[i] > t && (next < 0 || bp[i] < next)) next = bp[i];
+  }
+  return next;
+}
+
 // properties
 PROP_REQ [] = {
   { "U1", PROP_REAL, { 0, PROP_NO_STR }, PROP_NO_RANGE },
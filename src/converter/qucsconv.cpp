@@ -72,6 +72,8 @@ int csv2qucs   (struct actionset_t *, char *, char *);
 int zvr2qucs   (struct actionset_t *, char *, char *);
 int mdl2qucs   (struct actionset_t *, char *, char *);
 int qucs2mat   (struct actionset_t *, char *, char *);
+int qucs2bin   (struct actionset_t *, char *, char *);
+int bin2qucs   (struct actionset_t *, char *, char *);
 
 /* conversion definitions */
 struct actionset_t actionset[] = {
@@ -86,6 +88,8 @@ struct actionset_t actionset[] = {
   { "zvr",        "qucsdata",   zvr2qucs   },
   { "mdl",        "qucsdata",   mdl2qucs   },
   { "qucsdata",   "matlab",     qucs2mat   },
+  { "qucsdata",   "qucsbin",    qucs2bin   },
+  { "qucsbin",    "qucsdata",   bin2qucs   },
   { NULL, NULL, NULL}
 };
 
@@ -155,6 +159,8 @@ int main (int argc, char ** argv) {
   "  zvr         - qucsdata\n"
   "  mdl         - qucsdata\n"
   "  qucsdata    - matlab\n"
+  "  qucsdata    - qucsbin\n"
+  "  qucsbin     - qucsdata\n"
 	"\nReport bugs to <" PACKAGE_BUGREPORT ">.\n", argv[0]);
       return 0;
     }
@@ -372,6 +378,54 @@ int qucs2mat (struct actionset_t * action, char * infile, char * outfile) {
   return -1;
 }
 
+// Qucs dataset to binary Qucs dataset conversion.
+int qucs2bin (struct actionset_t * action, char * infile, char * outfile) {
+  int ret = 0;
+  if ((dataset_in = open_file (infile, "r")) == NULL) {
+    ret = -1;
+  } else if (dataset_parse () != 0) {
+    ret = -1;
+  } else if (dataset_result == NULL) {
+    ret = -1;
+  } else if (dataset_check (dataset_result) != 0) {
+    delete dataset_result;
+    dataset_result = NULL;
+    ret = -1;
+  }
+  qucs_data = dataset_result;
+  dataset_result = NULL;
+  dataset_lex_destroy ();
+  if (dataset_in)
+    fclose (dataset_in);
+  if (ret)
+    return -1;
+
+  if (!strcmp (action->out, "qucsbin")) {
+    qucs_data->setFile (outfile);
+    qucs_data->printBinary ();
+    return ret;
+  }
+  return -1;
+}
+
+// Binary Qucs dataset to Qucs dataset conversion.
+int bin2qucs (struct actionset_t * action, char * infile, char * outfile) {
+  dataset * data;
+  if (infile == NULL) {
+    fprintf (stderr, "binary datasets cannot be read from stdin\n");
+    return -1;
+  }
+  if ((data = dataset::load_binary (infile)) == NULL)
+    return -1;
+
+  if (!strcmp (action->out, "qucsdata")) {
+    data->setFile (outfile);
+    qucsdata_producer (data);
+  }
+  delete data;
+  return 0;
+}
+
 // CITIfile to Qucs conversion.
 int citi2qucs (struct actionset_t * action, char * infile, char * outfile) {
   int ret = 0;
@@ -31,7 +31,17 @@
 #include <string.h>
 #include <errno.h>
 #include <assert.h>
+#include <stdint.h>
 #include <cmath>
+#include <algorithm>
+
+#if HAVE_MMAP
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/types.h>
+#include <sys/stat.h>
+#include <sys/mman.h>
+#endif
 
 #include "logging.h"
 #include "complex.h"
@@ -406,15 +416,249 @@ void dataset::printData (vector * v, FILE * f) {
   }
 }
 
+/* The binary dataset format is a columnar image of the dataset.  It
+   starts with the magic string and two 32 bit words carrying the
+   format version and the number of vectors.  Each vector record
+   consists of four 32 bit words (flags, number of values, number of
+   dependencies and length of the name), the name, the names of the
+   dependencies each prefixed by its length, padding up to the next
+   multiple of eight bytes and finally the values as raw doubles.
+   Complex vectors store real and imaginary parts interleaved.  All
+   data is written in host byte order.  The values are aligned to eight
+   bytes, thus they are copied straight out of a memory-mapped file. */
+#define BINARY_MAGIC   "QucsBDat"
+#define BINARY_VERSION 1
+#define BINARY_INDEP   0x0001
+#define BINARY_COMPLEX 0x0002
+#define BINARY_CHUNK   1024
+
+// Writes the given vector as binary record into the file descriptor.
+void dataset::printBinaryVector (vector * v, int indep, FILE * f) {
+  uint32_t head[4];
+  int i, n = v->getSize ();
+  strlist * deps = indep ? NULL : v->getDependencies ();
+
+  // check whether there are any imaginary parts at all
+  head[0] = indep ? BINARY_INDEP : 0;
+  for (i = 0; i < n; i++) {
+    if (imag (v->get (i)) != 0.0) {
+      head[0] |= BINARY_COMPLEX;
+      break;
+    }
+  }
+  head[1] = n;
+  head[2] = deps ? deps->length () : 0;
+  head[3] = strlen (v->getName ());
+  fwrite (head, sizeof (uint32_t), 4, f);
+  fwrite (v->getName (), 1, head[3], f);
+  long pos = 4 * sizeof (uint32_t) + head[3];
+  if (deps) {
+    for (strlistiterator it (deps); *it; ++it) {
+      uint32_t len = strlen (*it);
+      fwrite (&len, sizeof (uint32_t), 1, f);
+      fwrite (*it, 1, len, f);
+      pos += sizeof (uint32_t) + len;
+    }
+  }
+
+  // pad the record header, all records start aligned
+  static const char pad[8] = { 0, 0, 0, 0, 0, 0, 0, 0 };
+  if (pos % 8) fwrite (pad, 1, 8 - pos % 8, f);
+
+  // write the values in chunks
+  double buf[2 * BINARY_CHUNK];
+  int cplx = head[0] & BINARY_COMPLEX;
+  for (i = 0; i < n; ) {
+    int k, len = std::min (n - i, BINARY_CHUNK);
+    for (k = 0; k < len; k++, i++) {
+      nr_complex_t c = v->get (i);
+      if (cplx) {
+	buf[2 * k + 0] = (double) real (c);
+	buf[2 * k + 1] = (double) imag (c);
+      } else {
+	buf[k] = (double) real (c);
+      }
+    }
+    fwrite (buf, sizeof (double), cplx ? 2 * len : len, f);
+  }
+}
+
+/* This function prints the current dataset representation in the
+   binary format either to the specified file name or to stdout. */
+void dataset::printBinary (void) {
+
+  FILE * f = stdout;
+
+  // open file for writing
+  if (file) {
+    if ((f = fopen (file, "wb")) == NULL) {
+      logprint (LOG_ERROR, "cannot create file `%s': %s\n",
+		file, strerror (errno));
+      return;
+    }
+  }
+
+  // print header
+  uint32_t head[2];
+  head[0] = BINARY_VERSION;
+  head[1] = countDependencies () + countVariables ();
+  fwrite (BINARY_MAGIC, 1, 8, f);
+  fwrite (head, sizeof (uint32_t), 2, f);
+
+  // print dependencies
+  for (vector * d = dependencies; d != NULL; d = (vector *) d->getNext ()) {
+    printBinaryVector (d, 1, f);
+  }
+
+  // print variables
+  for (vector * v = variables; v != NULL; v = (vector *) v->getNext ()) {
+    printBinaryVector (v, v->getDependencies () == NULL, f);
+  }
+
+  // close file if necessary
+  if (file) fclose (f);
+}
+
+/* Creates a dataset from the given binary dataset image.  Returns
+   NULL if the image is not valid. */
+dataset * dataset::decodeBinary (const char * buf, size_t len) {
+  uint32_t head[4];
+  size_t pos = 8 + 2 * sizeof (uint32_t);
+  if (len < pos || memcmp (buf, BINARY_MAGIC, 8)) return NULL;
+  memcpy (head, buf + 8, 2 * sizeof (uint32_t));
+  if (head[0] != BINARY_VERSION) return NULL;
+
+  dataset * data = new dataset ();
+  uint32_t r, count = head[1];
+  for (r = 0; r < count; r++) {
+    // read the record header and the name
+    if (len - pos < 4 * sizeof (uint32_t)) break;
+    memcpy (head, buf + pos, 4 * sizeof (uint32_t));
+    pos += 4 * sizeof (uint32_t);
+    if (len - pos < head[3]) break;
+    std::string name (buf + pos, head[3]);
+    pos += head[3];
+
+    // read the dependencies
+    strlist * deps = head[2] ? new strlist () : NULL;
+    uint32_t d;
+    for (d = 0; d < head[2]; d++) {
+      uint32_t n;
+      if (len - pos < sizeof (uint32_t)) break;
+      memcpy (&n, buf + pos, sizeof (uint32_t));
+      pos += sizeof (uint32_t);
+      if (len - pos < n) break;
+      deps->append (std::string (buf + pos, n).c_str ());
+      pos += n;
+    }
+    pos = (pos + 7) & ~((size_t) 7);
+
+    // check the number of values against the remaining image before
+    // allocating the vector
+    int cplx = head[0] & BINARY_COMPLEX;
+    size_t size = sizeof (double) * (cplx ? 2 : 1);
+    if (d != head[2] || pos > len || (len - pos) / size < head[1]) {
+      delete deps;
+      break;
+    }
+    vector * v = new vector (name, head[1]);
+
+    // read the values
+    const double * val = (const double *) (buf + pos);
+    for (uint32_t i = 0; i < head[1]; i++) {
+      if (cplx)
+	v->set (nr_complex_t (val[2 * i + 0], val[2 * i + 1]), i);
+      else
+	v->set ((nr_double_t) val[i], i);
+    }
+    pos += head[1] * size;
+
+    if (head[0] & BINARY_INDEP) {
+      delete deps;
+      v->setRequested (head[1]);
+      data->appendDependency (v);
+    } else {
+      v->setDependencies (deps);
+      data->appendVariable (v);
+    }
+  }
+
+  // incomplete file
+  if (r != count) {
+    delete data;
+    return NULL;
+  }
+  return data;
+}
+
+/* This static function reads a full dataset from the given binary
+   dataset file and returns it.  The file is memory-mapped if possible.
+   On failure the function emits appropriate error messages and
+   returns NULL. */
+dataset * dataset::load_binary (const char * file) {
+  dataset * data;
+#if HAVE_MMAP
+  int fd;
+  struct stat st;
+  if ((fd = open (file, O_RDONLY)) < 0 || fstat (fd, &st) != 0) {
+    logprint (LOG_ERROR, "error loading `%s': %s\n", file, strerror (errno));
+    if (fd >= 0) close (fd);
+    return NULL;
+  }
+  size_t len = st.st_size;
+  void * buf = len ? mmap (NULL, len, PROT_READ, MAP_PRIVATE, fd, 0) : NULL;
+  close (fd);
+  if (buf == MAP_FAILED) {
+    logprint (LOG_ERROR, "error loading `%s': %s\n", file, strerror (errno));
+    return NULL;
+  }
+  data = decodeBinary ((const char *) buf, len);
+  if (buf) munmap (buf, len);
+#else /* !HAVE_MMAP */
+  FILE * f;
+  if ((f = fopen (file, "rb")) == NULL) {
+    logprint (LOG_ERROR, "error loading `%s': %s\n", file, strerror (errno));
+    return NULL;
+  }
+  fseek (f, 0, SEEK_END);
+  size_t len = ftell (f);
+  fseek (f, 0, SEEK_SET);
+  char * buf = (char *) malloc (len + 1);
+  len = fread (buf, 1, len, f);
+  fclose (f);
+  data = decodeBinary (buf, len);
+  free (buf);
+#endif /* !HAVE_MMAP */
+
+  if (data == NULL) {
+    logprint (LOG_ERROR, "error loading `%s': invalid binary dataset\n",
+	      file);
+    return NULL;
+  }
+  if (dataset_check (data) != 0) {
+    delete data;
+    return NULL;
+  }
+  data->setFile (file);
+  return data;
+}
+
 /* This static function read a full dataset from the given file and
-   returns it.  On failure the function emits appropriate error
-   messages and returns NULL. */
+   returns it.  Binary datasets are detected by their magic string.
+   On failure the function emits appropriate error messages and
+   returns NULL. */
 dataset * dataset::load (const char * file) {
   FILE * f;
   if ((f = fopen (file, "r")) == NULL) {
     logprint (LOG_ERROR, "error loading `%s': %s\n", file, strerror (errno));
     return NULL;
   }
+  char magic[8];
+  if (fread (magic, 1, 8, f) == 8 && !memcmp (magic, BINARY_MAGIC, 8)) {
+    fclose (f);
+    return load_binary (file);
+  }
+  rewind (f);
   dataset_in = f;
   dataset_restart (dataset_in);
   if (dataset_parse () != 0) {
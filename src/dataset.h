@@ -54,6 +54,7 @@ class dataset : public object
   char * getFile (void);
   void setFile (const char *);
   void print (void);
+  void printBinary (void);
   void printData (qucs::vector *, FILE *);
   void printDependency (qucs::vector *, FILE *);
   void printVariable (qucs::vector *, FILE *);
@@ -65,6 +66,7 @@ class dataset : public object
   int isVariable (qucs::vector *);
   qucs::vector * findOrigin (char *);
   static dataset * load (const char *);
+  static dataset * load_binary (const char *);
   static dataset * load_touchstone (const char *);
   static dataset * load_csv (const char *);
   static dataset * load_citi (const char *);
@@ -74,6 +76,10 @@ class dataset : public object
   int countDependencies (void);
   int countVariables (void);
 
+ private:
+  void printBinaryVector (qucs::vector *, int, FILE *);
+  static dataset * decodeBinary (const char *, size_t);
+
  private:
   char * file;
   qucs::vector * dependencies;
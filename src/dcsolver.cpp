@@ -27,6 +27,7 @@
 #endif
 
 #include <stdio.h>
+#include <cmath>
 
 #include "object.h"
 #include "complex.h"
@@ -42,6 +43,7 @@ namespace qucs {
 // Constructor creates an unnamed instance of the dcsolver class.
 dcsolver::dcsolver () : nasolver<nr_double_t> () {
   saveOPs = 0;
+  statSubdivided = 0;
   type = ANALYSIS_DC;
   setDescription ("DC");
 }
@@ -49,6 +51,7 @@ dcsolver::dcsolver () : nasolver<nr_double_t> () {
 // Constructor creates a named instance of the dcsolver class.
 dcsolver::dcsolver (char * n) : nasolver<nr_double_t> (n) {
   saveOPs = 0;
+  statSubdivided = 0;
   type = ANALYSIS_DC;
   setDescription ("DC");
 }
@@ -61,6 +64,7 @@ dcsolver::~dcsolver () {
    based on the given dcsolver object. */
 dcsolver::dcsolver (dcsolver & o) : nasolver<nr_double_t> (o) {
   saveOPs = o.saveOPs;
+  statSubdivided = 0;
 }
 
 /* This is the DC netlist solver.  It prepares the circuit list and
@@ -70,14 +74,9 @@ int dcsolver::solve (void) {
   saveOPs |= !strcmp (getPropertyString ("saveOPs"), "yes") ? SAVE_OPS : 0;
   saveOPs |= !strcmp (getPropertyString ("saveAll"), "yes") ? SAVE_ALL : 0;
   const char * const solver = getPropertyString ("Solver");
-
-  // initialize node voltages, first guess for non-linear circuits and
-  // generate extra circuits if necessary
-  init ();
-  setCalculation ((calculate_func_t) &calc);
-
-  // start the iterative solver
-  solve_pre ();
+  bypass = !strcmp (getPropertyString ("Bypass"), "yes") ? 1 : 0;
+  threads = getPropertyInteger ("Threads");
+  statBypassed = statEvaluated = 0;
 
   // choose a solver
   if (!strcmp (solver, "CroutLU"))
@@ -90,9 +89,23 @@ int dcsolver::solve (void) {
     eqnAlgo = ALGO_QR_DECOMPOSITION_LS;
   else if (!strcmp (solver, "GolubSVD"))
     eqnAlgo = ALGO_SV_DECOMPOSITION;
+  else if (!strcmp (solver, "SparseLU"))
+    eqnAlgo = ALGO_LU_DECOMPOSITION_SPARSE;
+
+  // initialize node voltages, first guess for non-linear circuits and
+  // generate extra circuits if necessary
+  init ();
+  setCalculation ((calculate_func_t) &calc);
+
+  // start the iterative solver
+  solve_pre ();
+
+  // a continuation restarts at the first point of a parameter sweep
+  if (continuation != NULL && continuation->getSweepPoint () == 0)
+    resetContinuation ();
 
   // local variables for the fallback thingies
-  int retry = -1, error, fallback = 0, preferred;
+  int retry = -1, error, fallback = 0, preferred, subdivided = 0;
   int helpers[] = {
     CONV_SourceStepping,
     CONV_GMinStepping,
@@ -125,8 +138,13 @@ int dcsolver::solve (void) {
   else do {
     // Run the DC solver once.
     try_running () {
-      applyNodeset ();
+      // the fallbacks always start from the nodesets
+      if (retry < 0)
+	applyStartingValues ();
+      else
+	applyNodeset ();
       error = solve_nonlinear ();
+      statIterations += iterations;
 #if DEBUG
       if (!error) {
 	logprint (LOG_STATUS,
@@ -140,6 +158,13 @@ int dcsolver::solve (void) {
     catch_exception () {
     case EXCEPTION_NO_CONVERGENCE:
       pop_exception ();
+      // try smaller steps along the parameter sweep first
+      if (retry < 0 && continuation != NULL && contPoints > 0 &&
+	  !subdivideStep ()) {
+	error = 0;
+	subdivided = 1;
+	break;
+      }
       if (preferred == helpers[fallback] && preferred) fallback++;
       convHelper = helpers[fallback++];
       if (convHelper != -1) {
@@ -161,6 +186,21 @@ int dcsolver::solve (void) {
     }
   } while (retry != -1);
 
+  // keep the solution as initial guess of a warm started run, a
+  // subdivided step has already stored the current sweep point
+  if (!error && subnet->isNonLinear () && !subdivided) {
+    if (continuation != NULL)
+      storeContinuation (continuation->getSweepValue ());
+    else
+      storeSolution ();
+  }
+
+  if (statEvaluated > 0) {
+    logprint (LOG_STATUS, "NOTIFY: %s: %d of %d device evaluations "
+	      "bypassed\n", getName (), statBypassed,
+	      statBypassed + statEvaluated);
+  }
+
   // save results and cleanup the solver
   saveOperatingPoints ();
   saveResults ("V", "I", saveOPs);
@@ -169,13 +209,70 @@ int dcsolver::solve (void) {
   return 0;
 }
 
+/* This function subdivides the step from the previous point of a
+   parameter sweep continuation after the Newton iteration failed to
+   converge at the current point.  The intermediate points are solved
+   without saving any results.  It returns zero once the current sweep
+   point has been reached, non-zero if the subdivision failed or ran
+   out of steps before. */
+int dcsolver::subdivideStep (void) {
+  nr_double_t target = continuation->getSweepValue ();
+  nr_double_t from = contValue[1];
+  nr_double_t step = (target - from) / 2;
+  int error = 1, reached = 0;
+
+  for (int n = 0; n < DC_MAX_SUBDIVISIONS; n++) {
+    nr_double_t p = (std::abs (target - from) <= std::abs (step)) ?
+      target : from + step;
+    continuation->setSweepValue (p);
+    init ();
+    linearValid = 0;
+    applyStartingValues ();
+    try_running () {
+      error = solve_nonlinear ();
+      statIterations += iterations;
+    }
+    catch_exception () {
+    default:
+      pop_exception ();
+      break;
+    }
+    if (!error) {
+      statSubdivided++;
+      storeContinuation (p);
+      if (p == target) {
+	reached = 1;
+	break;
+      }
+      from = p;
+      step *= 2;
+    }
+    else step /= 2;
+  }
+  if (!reached) error = 1;
+#if DEBUG
+  logprint (LOG_STATUS, "NOTIFY: %s: step subdivision %s\n", getName (),
+	    error ? "failed" : "succeeded");
+#endif
+
+  // leave the circuit at the current sweep point
+  if (error) {
+    continuation->setSweepValue (target);
+    init ();
+    linearValid = 0;
+  }
+  return error;
+}
+
 /* Goes through the list of circuit objects and runs its calcDC()
-   function. */
+   function unless the evaluation of the circuit can be bypassed. */
 void dcsolver::calc (dcsolver * self) {
-  circuit * root = self->getNet()->getRoot ();
-  for (circuit * c = root; c != NULL; c = (circuit *) c->getNext ()) {
-    c->calcDC ();
-  }
+  self->evaluate ((evaluate_func_t) &calcCircuit);
+}
+
+// Runs the calcDC() function of the given circuit.
+void dcsolver::calcCircuit (circuit * c, dcsolver *) {
+  c->calcDC ();
 }
 
 /* Goes through the list of circuit objects and runs its initDC()
@@ -183,6 +280,7 @@ void dcsolver::calc (dcsolver * self) {
 void dcsolver::init (void) {
   circuit * root = subnet->getRoot ();
   for (circuit * c = root; c != NULL; c = (circuit *) c->getNext ()) {
+    c->setRealMNA (true);
     c->initDC ();
   }
 }
@@ -220,6 +318,8 @@ PROP_OPT [] = {
     PROP_RNG_STR6 ("none", "SourceStepping", "gMinStepping",
 		   "LineSearch", "Attenuation", "SteepestDescent") },
   { "Solver", PROP_STR, { PROP_NO_VAL, "CroutLU" }, PROP_RNG_SOL },
+  { "Bypass", PROP_STR, { PROP_NO_VAL, "no" }, PROP_RNG_YESNO },
+  { "Threads", PROP_INT, { 1, PROP_NO_STR }, PROP_MIN_VAL (1) },
   PROP_NO_PROP };
 struct define_t dcsolver::anadef =
   { "DC", 0, PROP_ACTION, PROP_NO_SUBSTRATE, PROP_LINEAR, PROP_DEF };
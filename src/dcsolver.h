@@ -27,6 +27,9 @@
 
 #include "nasolver.h"
 
+// Maximum number of steps subdividing a failed sweep step.
+#define DC_MAX_SUBDIVISIONS 32
+
 namespace qucs {
 
 class dcsolver : public nasolver<nr_double_t>
@@ -38,12 +41,18 @@ class dcsolver : public nasolver<nr_double_t>
   ~dcsolver ();
   int  solve (void);
   static void calc (dcsolver *);
+  static void calcCircuit (circuit *, dcsolver *);
   void init (void);
   void restart (void);
   void saveOperatingPoints (void);
+  int  getSubdivided (void) { return statSubdivided; }
+
+ private:
+  int  subdivideStep (void);
 
  private:
   int saveOPs;
+  int statSubdivided;
 };
 
 } // namespace qucs
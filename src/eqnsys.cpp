@@ -35,6 +35,9 @@
 #include <float.h>
 
 #include <limits>
+#include <algorithm>
+#include <set>
+#include <vector>
 
 #include "compat.h"
 #include "logging.h"
@@ -59,7 +62,9 @@ eqnsys<nr_type_t>::eqnsys () {
   T = R = NULL;
   nPvt = NULL;
   cMap = rMap = NULL;
+  As = NULL;
   update = 1;
+  refactor = factored = 0;
   pivoting = PIVOT_PARTIAL;
   N = 0;
 }
@@ -89,7 +94,10 @@ eqnsys<nr_type_t>::eqnsys (eqnsys & e) {
   B = e.B ? new tvector<nr_type_t> (*(e.B)) : NULL;
   cMap = rMap = NULL;
   nPvt = NULL;
+  As = e.As;
   update = 1;
+  refactor = e.refactor;
+  factored = 0;
   X = e.X;
   N = 0;
 }
@@ -105,9 +113,11 @@ void eqnsys<nr_type_t>::passEquationSys (tmatrix<nr_type_t> * nA,
 					 tvector<nr_type_t> * nB) {
   if (nA != NULL) {
     A = nA;
+    As = NULL;
     update = 1;
     if (N != A->getCols ()) {
       N = A->getCols ();
+      factored = 0;
       delete[] cMap; cMap = new int[N];
       delete[] rMap; rMap = new int[N];
       delete[] nPvt; nPvt = new nr_double_t[N];
@@ -117,7 +127,35 @@ void eqnsys<nr_type_t>::passEquationSys (tmatrix<nr_type_t> * nA,
     update = 0;
   }
   delete B;
-  B = new tvector<nr_type_t> (*nB);
+  B = nB ? new tvector<nr_type_t> (*nB) : NULL;
+  X = refX;
+}
+
+/*! This function passes a sparse left hand side matrix to the
+   equation system solver.  It is meant to be used with the sparse LU
+   algorithms only.  Otherwise it works the same way as the above
+   function. */
+template <class nr_type_t>
+void eqnsys<nr_type_t>::passEquationSys (spmatrix<nr_type_t> * nA,
+					 tvector<nr_type_t> * refX,
+					 tvector<nr_type_t> * nB) {
+  if (nA != NULL) {
+    As = nA;
+    A = NULL;
+    update = 1;
+    if (N != As->getCols ()) {
+      N = As->getCols ();
+      factored = 0;
+      delete[] cMap; cMap = new int[N];
+      delete[] rMap; rMap = new int[N];
+      delete[] nPvt; nPvt = new nr_double_t[N];
+    }
+  }
+  else {
+    update = 0;
+  }
+  delete B;
+  B = nB ? new tvector<nr_type_t> (*nB) : NULL;
   X = refX;
 }
 
@@ -175,13 +213,72 @@ void eqnsys<nr_type_t>::solve (void) {
   case ALGO_QR_DECOMPOSITION_2:
     solve_qrh ();
     break;
+  case ALGO_LU_DECOMPOSITION_SPARSE:
+    solve_lu_sparse ();
+    break;
+  case ALGO_LU_FACTORIZATION_SPARSE:
+    factorize_lu_sparse ();
+    break;
+  case ALGO_LU_SUBSTITUTION_SPARSE:
+    substitute_lu_sparse ();
+    break;
+  case ALGO_GMRES:
+    solve_gmres ();
+    break;
   }
 #if DEBUG && 0
   logprint (LOG_STATUS, "NOTIFY: %dx%d eqnsys solved in %ld seconds\n",
-	    A->getRows (), A->getCols (), time (NULL) - t);
+	    N, N, time (NULL) - t);
 #endif
 }
 
+/*! The function solves the equation system for all columns of the
+   right hand side matrix B at once and stores the solutions into the
+   columns of the matrix X.  The left hand side must have been passed
+   by passEquationSys() before, the right hand side vector passed there
+   is not used.  The matrix is LU decomposed once (unless a
+   substitution algorithm is requested) and the substitutions are then
+   run on blocks of columns.  Algorithms other than the LU
+   decompositions fall back to Crout's LU decomposition. */
+template <class nr_type_t>
+void eqnsys<nr_type_t>::solve (tmatrix<nr_type_t> * Xm,
+			       tmatrix<nr_type_t> * Bm) {
+  switch (algo) {
+  case ALGO_LU_DECOMPOSITION_DOOLITTLE:
+    if (update) factorize_lu_doolittle ();
+    /* fall through */
+  case ALGO_LU_SUBSTITUTION_DOOLITTLE:
+    substitute_lu_doolittle (Xm, Bm);
+    break;
+  case ALGO_LU_DECOMPOSITION_SPARSE:
+  case ALGO_LU_SUBSTITUTION_SPARSE:
+    if (As != NULL) {
+      if (update && algo == ALGO_LU_DECOMPOSITION_SPARSE)
+	factorize_lu_sparse ();
+      // the sparse factors are column oriented, solve column-wise
+      tvector<nr_type_t> * b = B, * x = X, v (N);
+      for (int c = 0; c < Bm->getCols (); c++) {
+	B = new tvector<nr_type_t> (Bm->getCol (c));
+	X = &v;
+	substitute_lu_sparse ();
+	for (int r = 0; r < N; r++) (*Xm) (r, c) = v (r);
+	delete B;
+      }
+      B = b;
+      X = x;
+      break;
+    }
+    // without a sparse matrix use Crout's decomposition
+    /* fall through */
+  default:
+    if (update && algo != ALGO_LU_SUBSTITUTION_CROUT) factorize_lu_crout ();
+    /* fall through */
+  case ALGO_LU_SUBSTITUTION_CROUT:
+    substitute_lu_crout (Xm, Bm);
+    break;
+  }
+}
+
 /*! Simple matrix inversion is used to solve the equation system. */
 template <class nr_type_t>
 void eqnsys<nr_type_t>::solve_inverse (void) {
@@ -315,15 +412,40 @@ void eqnsys<nr_type_t>::solve_lu_doolittle (void) {
   substitute_lu_doolittle ();
 }
 
+/*! The threshold used when refactoring a matrix with the pivot
+   sequence of a previous LU decomposition.  A previous pivot is kept
+   as long as its (scaled) magnitude is within this fraction of the
+   largest candidate, respectively of its row in the dense case,
+   otherwise pivoting is done again. */
+#define REFACTOR_PIVOT_TOL 1e-3
+
 /*! This function decomposes the left hand matrix into an upper U and
    lower L matrix.  The algorithm is called LU decomposition (Crout's
    definition).  The function performs the actual LU decomposition of
-   the matrix A using (implicit) partial row pivoting. */
+   the matrix A using (implicit) partial row pivoting.  In refactor
+   mode the rows are brought into the order of the previous
+   decomposition and the pivots are kept without searching the column
+   unless they became too small. */
 template <class nr_type_t>
 void eqnsys<nr_type_t>::factorize_lu_crout (void) {
   nr_double_t d, MaxPivot;
   nr_type_t f;
   int k, c, r, pivot;
+  int reuse = refactor && factored;
+
+  // apply the row exchanges of the previous decomposition in place,
+  // following each cycle of the permutation once
+  if (reuse) {
+    std::vector<bool> done (N, false);
+    for (r = 0; r < N; r++) {
+      for (c = r; !done[c] && rMap[c] != r; c = k) {
+	k = rMap[c];
+	A->exchangeRows (c, k);
+	done[c] = true;
+      }
+      done[c] = true;
+    }
+  }
 
   // initialize pivot exchange table
   for (r = 0; r < N; r++) {
@@ -332,7 +454,7 @@ void eqnsys<nr_type_t>::factorize_lu_crout (void) {
 	MaxPivot = d;
     if (MaxPivot <= 0) MaxPivot = NR_TINY;
     nPvt[r] = 1 / MaxPivot;
-    rMap[r] = r;
+    if (!reuse) rMap[r] = r;
   }
 
   // decompose the matrix into L (lower) and U (upper) matrix
@@ -344,14 +466,22 @@ void eqnsys<nr_type_t>::factorize_lu_crout (void) {
       A_(r, c) = f / A_(r, r);
     }
     // lower matrix entries
-    for (MaxPivot = 0, pivot = r; r < N; r++) {
+    for (; r < N; r++) {
       f = A_(r, c);
       for (k = 0; k < c; k++) f -= A_(r, k) * A_(k, c);
       A_(r, c) = f;
-      // larger pivot ?
-      if ((d = nPvt[r] * abs (f)) > MaxPivot) {
-	MaxPivot = d;
-	pivot = r;
+    }
+
+    // keep the previous pivot if it is still acceptable, otherwise
+    // look for the largest one
+    pivot = c;
+    if (!reuse || (MaxPivot = nPvt[c] * abs (A_(c, c))) < REFACTOR_PIVOT_TOL) {
+      for (MaxPivot = 0, r = c; r < N; r++) {
+	// larger pivot ?
+	if ((d = nPvt[r] * abs (A_(r, c))) > MaxPivot) {
+	  MaxPivot = d;
+	  pivot = r;
+	}
       }
     }
 
@@ -376,6 +506,7 @@ void eqnsys<nr_type_t>::factorize_lu_crout (void) {
       Swap (nr_double_t, nPvt[c], nPvt[pivot]);
     }
   }
+  factored = 1;
 #if LU_FAILURE
  fail:
 #endif
@@ -477,6 +608,88 @@ void eqnsys<nr_type_t>::substitute_lu_crout (void) {
   }
 }
 
+/*! The number of right hand side columns processed at once by the
+   blocked forward and backward substitutions. */
+#define LU_BLOCK 32
+
+/*! The function runs the forward and backward substitutions of
+   Crout's LU decomposition for each column of the matrix B storing
+   the solutions into the matrix X.  The columns are processed in
+   blocks, so each element of the LU decomposed matrix is fetched once
+   per block only and the inner loops run over consecutive memory.
+   The results are the same as for the single column version. */
+template <class nr_type_t>
+void eqnsys<nr_type_t>::substitute_lu_crout (tmatrix<nr_type_t> * Xm,
+					     tmatrix<nr_type_t> * Bm) {
+  int i, c, j, j0, j1, M = Bm->getCols ();
+  nr_type_t f, * x, * y, * b = Bm->getData (), * xd = Xm->getData ();
+
+  for (j0 = 0; j0 < M; j0 += LU_BLOCK) {
+    j1 = std::min (j0 + LU_BLOCK, M);
+
+    // forward substitution in order to solve LY = B
+    for (i = 0; i < N; i++) {
+      x = &xd[i * M];
+      y = &b[rMap[i] * M];
+      for (j = j0; j < j1; j++) x[j] = y[j];
+      for (c = 0; c < i; c++) {
+	if ((f = A_(i, c)) == 0.0) continue;
+	y = &xd[c * M];
+	for (j = j0; j < j1; j++) x[j] -= f * y[j];
+      }
+      f = A_(i, i);
+      for (j = j0; j < j1; j++) x[j] /= f;
+    }
+
+    // backward substitution in order to solve UX = Y
+    for (i = N - 1; i >= 0; i--) {
+      x = &xd[i * M];
+      for (c = i + 1; c < N; c++) {
+	if ((f = A_(i, c)) == 0.0) continue;
+	y = &xd[c * M];
+	for (j = j0; j < j1; j++) x[j] -= f * y[j];
+      }
+    }
+  }
+}
+
+/*! The function runs the blocked forward and backward substitutions
+   of Doolittle's LU decomposition for each column of the matrix B. */
+template <class nr_type_t>
+void eqnsys<nr_type_t>::substitute_lu_doolittle (tmatrix<nr_type_t> * Xm,
+						 tmatrix<nr_type_t> * Bm) {
+  int i, c, j, j0, j1, M = Bm->getCols ();
+  nr_type_t f, * x, * y, * b = Bm->getData (), * xd = Xm->getData ();
+
+  for (j0 = 0; j0 < M; j0 += LU_BLOCK) {
+    j1 = std::min (j0 + LU_BLOCK, M);
+
+    // forward substitution in order to solve LY = B
+    for (i = 0; i < N; i++) {
+      x = &xd[i * M];
+      y = &b[rMap[i] * M];
+      for (j = j0; j < j1; j++) x[j] = y[j];
+      for (c = 0; c < i; c++) {
+	if ((f = A_(i, c)) == 0.0) continue;
+	y = &xd[c * M];
+	for (j = j0; j < j1; j++) x[j] -= f * y[j];
+      }
+    }
+
+    // backward substitution in order to solve UX = Y
+    for (i = N - 1; i >= 0; i--) {
+      x = &xd[i * M];
+      for (c = i + 1; c < N; c++) {
+	if ((f = A_(i, c)) == 0.0) continue;
+	y = &xd[c * M];
+	for (j = j0; j < j1; j++) x[j] -= f * y[j];
+      }
+      f = A_(i, i);
+      for (j = j0; j < j1; j++) x[j] /= f;
+    }
+  }
+}
+
 /*! The function is used in order to run the forward and backward
    substitutions using the LU decomposed matrix (Doolittle's
    definition - Lii are ones).  This function is here because of
@@ -502,6 +715,328 @@ void eqnsys<nr_type_t>::substitute_lu_doolittle (void) {
   }
 }
 
+/*! The threshold for the partial pivoting of the sparse LU
+   decomposition.  The diagonal element is preferred as pivot as long
+   as its magnitude is within this fraction of the largest candidate,
+   which keeps the fill-reducing ordering intact. */
+#define SPARSE_PIVOT_TOL 0.1
+
+/*! The function uses the sparse LU decomposition and the appropriate
+   forward and backward substitutions in order to solve the linear
+   equation system.  If no sparse matrix has been passed to the
+   equation system solver it falls back to the dense Crout LU
+   decomposition. */
+template <class nr_type_t>
+void eqnsys<nr_type_t>::solve_lu_sparse (void) {
+  if (As == NULL) {
+    solve_lu_crout ();
+    return;
+  }
+
+  // skip decomposition if requested
+  if (update) {
+    // perform LU composition
+    factorize_lu_sparse ();
+  }
+
+  // finally solve the equation system
+  substitute_lu_sparse ();
+}
+
+/*! This function computes a fill-reducing column ordering for the
+   sparse matrix.  It applies the minimum degree heuristic to the
+   symmetric structure of A+A'.  The ordering is kept as long as the
+   structure of the matrix does not change.  The function returns
+   non-zero if a new ordering has been computed. */
+template <class nr_type_t>
+int eqnsys<nr_type_t>::order_sparse (void) {
+  const int * Ap = As->getColPtr ();
+  const int * Ai = As->getRowIdx ();
+  int nnz = Ap[N];
+
+  // is the previous ordering still valid?
+  if ((int) qMap.size () == N && (int) sIdx.size () == nnz &&
+      std::equal (Ap, Ap + N + 1, sPtr.begin ()) &&
+      std::equal (Ai, Ai + nnz, sIdx.begin ()))
+    return 0;
+  sPtr.assign (Ap, Ap + N + 1);
+  sIdx.assign (Ai, Ai + nnz);
+
+  // build the adjacency structure of A+A' without diagonal
+  std::vector< std::vector<int> > adj (N);
+  int k, c, p;
+  for (c = 0; c < N; c++) {
+    for (p = Ap[c]; p < Ap[c + 1]; p++) {
+      if (Ai[p] == c) continue;
+      adj[c].push_back (Ai[p]);
+      adj[Ai[p]].push_back (c);
+    }
+  }
+  std::set< std::pair<int,int> > degree;
+  for (c = 0; c < N; c++) {
+    std::sort (adj[c].begin (), adj[c].end ());
+    adj[c].erase (std::unique (adj[c].begin (), adj[c].end ()), adj[c].end ());
+    degree.insert (std::make_pair ((int) adj[c].size (), c));
+  }
+
+  // eliminate nodes of minimum degree, neighbours form a clique then
+  std::vector<char> done (N, 0);
+  std::vector<int> merged;
+  qMap.resize (N);
+  for (k = 0; k < N; k++) {
+    int v = degree.begin()->second;
+    degree.erase (degree.begin ());
+    qMap[k] = v;
+    done[v] = 1;
+    std::vector<int> & nb = adj[v];
+    for (int u : nb) {
+      if (done[u]) continue;
+      merged.clear ();
+      std::vector<int>::iterator a = adj[u].begin (), b = nb.begin ();
+      while (a != adj[u].end () || b != nb.end ()) {
+	int i;
+	if (b == nb.end () || (a != adj[u].end () && *a < *b)) i = *a++;
+	else if (a == adj[u].end () || *b < *a) i = *b++;
+	else { i = *a++; b++; }
+	if (i != u && !done[i]) merged.push_back (i);
+      }
+      degree.erase (std::make_pair ((int) adj[u].size (), u));
+      adj[u].swap (merged);
+      degree.insert (std::make_pair ((int) adj[u].size (), u));
+    }
+    std::vector<int> ().swap (nb);
+  }
+  return 1;
+}
+
+/*! Helper function for the sparse LU decomposition.  It runs a depth
+   first search in the graph of the L matrix starting at row j and
+   pushes all rows reached onto the output stack xi (growing from top
+   downwards).  The mark array uses the current column k as stamp. */
+template <class nr_type_t>
+int eqnsys<nr_type_t>::reach_sparse (int j, int k, int top, int * xi,
+				     int * stack, int * pstack, int * mark) {
+  int head = 0, p, J, done;
+  stack[0] = j;
+  while (head >= 0) {
+    j = stack[head];
+    J = pInv[j];
+    if (mark[j] != k) {
+      mark[j] = k;
+      pstack[head] = J < 0 ? 0 : Lp[J];
+    }
+    done = 1;
+    int pend = J < 0 ? 0 : Lp[J + 1];
+    for (p = pstack[head]; p < pend; p++) {
+      int i = Li[p];
+      if (mark[i] == k) continue;
+      pstack[head] = p + 1;
+      stack[++head] = i;
+      done = 0;
+      break;
+    }
+    if (done) {
+      head--;
+      xi[--top] = j;
+    }
+  }
+  return top;
+}
+
+/*! This function decomposes the sparse left hand matrix into a lower
+   L (with unity diagonal) and an upper U matrix using the left-looking
+   algorithm by Gilbert and Peierls.  The columns are processed in the
+   fill-reducing order, the rows are chosen by threshold partial
+   pivoting.  The factors are stored in compressed column format. */
+template <class nr_type_t>
+void eqnsys<nr_type_t>::factorize_lu_sparse (void) {
+  if (As == NULL) {
+    factorize_lu_crout ();
+    return;
+  }
+
+  const int * Ap = As->getColPtr ();
+  const int * Ai = As->getRowIdx ();
+  const nr_type_t * Ax = As->getData ();
+  int k, p, px, top, i, j;
+
+  // find fill-reducing column order, in refactor mode try to reuse
+  // the previous pivot sequence if the structure did not change
+  if (!order_sparse () && refactor && factored &&
+      (int) Lp.size () == N + 1 && refactorize_lu_sparse ())
+    return;
+
+  // work arrays
+  std::vector<int> xi (N), stack (N), pstack (N), mark (N, -1);
+  std::vector<nr_type_t> x (N, 0.0);
+  pInv.assign (N, -1);
+  Lp.assign (1, 0); Li.clear (); Lx.clear ();
+  Up.assign (1, 0); Ui.clear (); Ux.clear ();
+
+  for (k = 0; k < N; k++) {
+    int col = qMap[k];
+
+    // symbolic step: rows reachable by solving L * x = A(:,col)
+    top = N;
+    for (p = Ap[col]; p < Ap[col + 1]; p++) {
+      if (mark[Ai[p]] != k)
+	top = reach_sparse (Ai[p], k, top, xi.data (), stack.data (),
+			    pstack.data (), mark.data ());
+    }
+
+    // numeric step: sparse triangular solve
+    for (px = top; px < N; px++) x[xi[px]] = 0.0;
+    for (p = Ap[col]; p < Ap[col + 1]; p++) x[Ai[p]] = Ax[p];
+    for (px = top; px < N; px++) {
+      j = xi[px];
+      int J = pInv[j];
+      if (J < 0) continue;
+      nr_type_t f = x[j];
+      for (p = Lp[J]; p < Lp[J + 1]; p++) x[Li[p]] -= Lx[p] * f;
+    }
+
+    // store U entries and look for the largest pivot candidate
+    int ipiv = -1;
+    nr_double_t MaxPivot = -1, d;
+    for (px = top; px < N; px++) {
+      i = xi[px];
+      if (pInv[i] < 0) {
+	if ((d = abs (x[i])) > MaxPivot) {
+	  MaxPivot = d;
+	  ipiv = i;
+	}
+      }
+      else {
+	Ui.push_back (pInv[i]);
+	Ux.push_back (x[i]);
+      }
+    }
+
+    // prefer the diagonal element
+    if (pInv[col] < 0 && mark[col] == k &&
+	abs (x[col]) >= SPARSE_PIVOT_TOL * MaxPivot && abs (x[col]) > 0)
+      ipiv = col;
+
+    // check pivot element and insert virtual resistance
+    nr_type_t pivot;
+    if (ipiv < 0 || MaxPivot <= 0) {
+      // structurally singular column, take any row not yet pivoted
+      if (ipiv < 0) {
+	for (ipiv = col, i = 0; pInv[ipiv] >= 0; i++) ipiv = i;
+      }
+      qucs::exception * e = new qucs::exception (EXCEPTION_SINGULAR);
+      e->setText ("no pivot != 0 found during sparse LU decomposition");
+      e->setData (ipiv);
+      throw_exception (e);
+      pivot = NR_TINY;
+    }
+    else {
+      pivot = x[ipiv];
+    }
+    Ui.push_back (k);
+    Ux.push_back (pivot);
+    Up.push_back (Ui.size ());
+    pInv[ipiv] = k;
+    rMap[k] = ipiv;
+
+    // store L entries divided by the pivot element
+    for (px = top; px < N; px++) {
+      i = xi[px];
+      if (pInv[i] < 0) {
+	Li.push_back (i);
+	Lx.push_back (x[i] / pivot);
+      }
+      x[i] = 0.0;
+    }
+    Lp.push_back (Li.size ());
+  }
+
+  // finally renumber the rows of L into pivot order
+  for (p = 0; p < (int) Li.size (); p++) Li[p] = pInv[Li[p]];
+  factored = 1;
+}
+
+/*! This function recomputes the sparse LU decomposition using the
+   pivot sequence and the structure of the L and U factors of the
+   previous decomposition.  Only the numeric work is done here, there
+   is no search for reachable rows and pivots.  If a pivot element
+   became too small compared to the remaining elements in its column
+   the function gives up and returns zero, the caller then has to run
+   the full decomposition.  Otherwise it returns non-zero. */
+template <class nr_type_t>
+int eqnsys<nr_type_t>::refactorize_lu_sparse (void) {
+  const int * Ap = As->getColPtr ();
+  const int * Ai = As->getRowIdx ();
+  const nr_type_t * Ax = As->getData ();
+  std::vector<nr_type_t> x (N, 0.0);
+  nr_double_t MaxPivot, d;
+  int k, p, q, j;
+
+  for (k = 0; k < N; k++) {
+    int col = qMap[k];
+
+    // scatter column into the work vector (in pivot order)
+    for (p = Ap[col]; p < Ap[col + 1]; p++) x[pInv[Ai[p]]] = Ax[p];
+
+    // sparse triangular solve, U entries are stored in topological order
+    for (p = Up[k]; p < Up[k + 1] - 1; p++) {
+      j = Ui[p];
+      nr_type_t f = Ux[p] = x[j];
+      x[j] = 0.0;
+      for (q = Lp[j]; q < Lp[j + 1]; q++) x[Li[q]] -= Lx[q] * f;
+    }
+
+    // check the pivot element against the remaining column entries
+    nr_type_t pivot = x[k];
+    x[k] = 0.0;
+    for (MaxPivot = 0, q = Lp[k]; q < Lp[k + 1]; q++)
+      if ((d = abs (x[Li[q]])) > MaxPivot) MaxPivot = d;
+    if (abs (pivot) <= 0 || abs (pivot) < REFACTOR_PIVOT_TOL * MaxPivot)
+      return 0;
+
+    // store U diagonal and L entries divided by the pivot element
+    Ux[Up[k + 1] - 1] = pivot;
+    for (q = Lp[k]; q < Lp[k + 1]; q++) {
+      Lx[q] = x[Li[q]] / pivot;
+      x[Li[q]] = 0.0;
+    }
+  }
+  return 1;
+}
+
+/*! The function is used in order to run the forward and backward
+   substitutions using the sparse LU decomposed matrix. */
+template <class nr_type_t>
+void eqnsys<nr_type_t>::substitute_lu_sparse (void) {
+  if (As == NULL) {
+    substitute_lu_crout ();
+    return;
+  }
+
+  std::vector<nr_type_t> y (N);
+  int i, p;
+
+  // apply row permutation
+  for (i = 0; i < N; i++) y[i] = B_(rMap[i]);
+
+  // forward substitution in order to solve LY = B (unity diagonal)
+  for (i = 0; i < N; i++) {
+    nr_type_t f = y[i];
+    for (p = Lp[i]; p < Lp[i + 1]; p++) y[Li[p]] -= Lx[p] * f;
+  }
+
+  // backward substitution in order to solve UX = Y, the diagonal
+  // element is the last one in each column
+  for (i = N - 1; i >= 0; i--) {
+    y[i] /= Ux[Up[i + 1] - 1];
+    nr_type_t f = y[i];
+    for (p = Up[i]; p < Up[i + 1] - 1; p++) y[Ui[p]] -= Ux[p] * f;
+  }
+
+  // undo column permutation
+  for (i = 0; i < N; i++) X_(qMap[i]) = y[i];
+}
+
 /*! The function solves the equation system using a full-step iterative
    method (called Jacobi's method) or a single-step method (called
    Gauss-Seidel) depending on the given algorithm.  If the current X
@@ -594,6 +1129,136 @@ void eqnsys<nr_type_t>::solve_iterative (void) {
 #endif
 }
 
+/*! The dimension of the Krylov subspace after which GMRES restarts
+   and the relative residual the iteration has to reach. */
+#define GMRES_RESTART 50
+#define GMRES_RELTOL  1e-12
+
+/*! The function solves the equation system using the restarted
+   generalized minimal residual method (GMRES) with a diagonal right
+   preconditioner.  The current X vector is used as initial guess, in
+   a Newton-Raphson iteration it is usually close to the solution.
+   Each iteration requires a single matrix-vector product only and
+   neither the matrix A nor the B vector are modified.  If there is no
+   convergence the function falls back to LU decomposition.
+
+   The harmonic balance Jacobian is assembled as a dense matrix anyway,
+   so the products are done on it directly.  Its rows are scaled by
+   conductances spanning many decades and by the frequency dependent
+   susceptances, which the Jacobi (diagonal) preconditioner removes at
+   the cost of N divisions.  An incomplete factorization would cost
+   about as much as the LU decomposition GMRES is meant to avoid.  The
+   iteration count is limited to N, thus the matrix-vector products
+   stay below the N^3 operations of the LU decomposition plus the
+   orthogonalization within each restart cycle. */
+template <class nr_type_t>
+void eqnsys<nr_type_t>::solve_gmres (void) {
+  int i, j, k, r, c, it = 0, conv = 0;
+  int m = std::min (N, GMRES_RESTART);
+  int MaxIter = N; // -> less than N^3 operations
+  nr_double_t bnorm, beta, h;
+  nr_type_t f, t;
+
+  std::vector<nr_type_t> D (N), w (N), z (N), g (m + 1), y (m);
+  std::vector<nr_type_t> cs (m), sn (m), H ((m + 1) * m), V ((m + 1) * N);
+
+  // diagonal preconditioner
+  for (r = 0; r < N; r++) D[r] = A_(r, r) != 0.0 ? 1.0 / A_(r, r) : 1.0;
+
+  // the initial guess must be usable
+  for (bnorm = 0, r = 0; r < N; r++) {
+    bnorm += norm (B_(r));
+    if (!std::isfinite (abs (X_(r)))) X_(r) = 0;
+  }
+  if ((bnorm = sqrt (bnorm)) == 0) {
+    for (r = 0; r < N; r++) X_(r) = 0;
+    return;
+  }
+
+  for (;;) {
+    // residual of the current solution
+    for (beta = 0, r = 0; r < N; r++) {
+      for (f = B_(r), c = 0; c < N; c++) f -= A_(r, c) * X_(c);
+      w[r] = f;
+      beta += norm (f);
+    }
+    beta = sqrt (beta);
+    if (beta <= GMRES_RELTOL * bnorm) { conv = 1; break; }
+    if (!std::isfinite (beta) || it >= MaxIter) break;
+
+    // start Arnoldi process with normalized residual
+    for (r = 0; r < N; r++) V[r] = w[r] / beta;
+    for (j = 0; j <= m; j++) g[j] = 0;
+    g[0] = beta;
+
+    for (j = 0; j < m && it < MaxIter; j++, it++) {
+      nr_type_t * v = &V[j * N];
+      // w = A * D * v
+      for (c = 0; c < N; c++) z[c] = D[c] * v[c];
+      for (r = 0; r < N; r++) {
+	for (f = 0, c = 0; c < N; c++) f += A_(r, c) * z[c];
+	w[r] = f;
+      }
+      // modified Gram-Schmidt orthogonalization
+      for (k = 0; k <= j; k++) {
+	nr_type_t * u = &V[k * N];
+	for (f = 0, r = 0; r < N; r++) f += conj (u[r]) * w[r];
+	H[k * m + j] = f;
+	for (r = 0; r < N; r++) w[r] -= f * u[r];
+      }
+      for (h = 0, r = 0; r < N; r++) h += norm (w[r]);
+      h = sqrt (h);
+      H[(j + 1) * m + j] = h;
+      if (h != 0) for (r = 0; r < N; r++) V[(j + 1) * N + r] = w[r] / h;
+
+      // apply previous Givens rotations to the new column
+      for (k = 0; k < j; k++) {
+	t = cs[k] * H[k * m + j] + sn[k] * H[(k + 1) * m + j];
+	H[(k + 1) * m + j] = -conj (sn[k]) * H[k * m + j] +
+	  cs[k] * H[(k + 1) * m + j];
+	H[k * m + j] = t;
+      }
+      // compute new rotation eliminating the subdiagonal element
+      nr_double_t a = abs (H[j * m + j]);
+      nr_double_t n = sqrt (a * a + h * h);
+      if (a == 0) {
+	cs[j] = 0;
+	sn[j] = 1;
+      } else {
+	cs[j] = a / n;
+	sn[j] = H[j * m + j] / a * h / n;
+      }
+      H[j * m + j] = cs[j] * H[j * m + j] + sn[j] * h;
+      H[(j + 1) * m + j] = 0;
+      g[j + 1] = -conj (sn[j]) * g[j];
+      g[j] = cs[j] * g[j];
+
+      // check residual norm
+      if (abs (g[j + 1]) <= GMRES_RELTOL * bnorm || h == 0) {
+	j++; it++;
+	break;
+      }
+    }
+
+    // solve the upper triangular system H * y = g
+    for (i = j - 1; i >= 0; i--) {
+      for (f = g[i], k = i + 1; k < j; k++) f -= H[i * m + k] * y[k];
+      y[i] = f / H[i * m + i];
+    }
+    // update the solution X = X + D * V * y
+    for (r = 0; r < N; r++) {
+      for (f = 0, k = 0; k < j; k++) f += V[k * N + r] * y[k];
+      X_(r) += D[r] * f;
+    }
+  }
+
+  if (!conv) {
+    logprint (LOG_ERROR,
+	      "WARNING: no convergence after %d gmres iterations\n", it);
+    solve_lu_crout ();
+  }
+}
+
 /*! The function solves the linear equation system using a single-step
    iterative algorithm.  It is a modification of the Gauss-Seidel
    method and is called successive over relaxation.  The function uses
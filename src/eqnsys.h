@@ -26,6 +26,7 @@
 #define __EQNSYS_H__
 
 #include <limits>
+#include <vector>
 
 //! Definition of equation system solving algorithms.
 enum algo_type {
@@ -47,6 +48,12 @@ enum algo_type {
   ALGO_SV_DECOMPOSITION           = 0x1000,
   // testing
   ALGO_QR_DECOMPOSITION_2         = 0x2000,
+  // sparse matrices
+  ALGO_LU_FACTORIZATION_SPARSE    = 0x4000,
+  ALGO_LU_SUBSTITUTION_SPARSE     = 0x8000,
+  ALGO_LU_DECOMPOSITION_SPARSE    = 0xC000,
+  // Krylov subspace methods
+  ALGO_GMRES                      = 0x10000,
 };
 
 //! Definition of pivoting strategies.
@@ -58,6 +65,7 @@ enum pivot_type {
 
 #include "tvector.h"
 #include "tmatrix.h"
+#include "spmatrix.h"
 
 namespace qucs {
 
@@ -70,12 +78,21 @@ class eqnsys
   ~eqnsys ();
   void setAlgo (int a) { algo = a; }
   int  getAlgo (void) { return algo; }
+  /*! In refactor mode a LU decomposition reuses the pivot sequence of
+     the previous one as long as the pivots stay acceptable. */
+  void setRefactor (int r) { refactor = r; }
+  int  getRefactor (void) { return refactor; }
   void passEquationSys (tmatrix<nr_type_t> *, tvector<nr_type_t> *,
 			tvector<nr_type_t> *);
+  void passEquationSys (spmatrix<nr_type_t> *, tvector<nr_type_t> *,
+			tvector<nr_type_t> *);
   void solve (void);
+  void solve (tmatrix<nr_type_t> *, tmatrix<nr_type_t> *);
 
  private:
   int update;
+  int refactor;
+  int factored;
   int algo;
   int pivoting;
   int * rMap;
@@ -92,6 +109,15 @@ class eqnsys
   tvector<nr_double_t> * S;
   tvector<nr_double_t> * E;
 
+  // sparse matrix and its LU factors
+  spmatrix<nr_type_t> * As;
+  std::vector<int> qMap;
+  std::vector<int> pInv;
+  std::vector<int> sPtr;
+  std::vector<int> sIdx;
+  std::vector<int> Lp, Li, Up, Ui;
+  std::vector<nr_type_t> Lx, Ux;
+
   void solve_inverse (void);
   void solve_gauss (void);
   void solve_gauss_jordan (void);
@@ -101,6 +127,14 @@ class eqnsys
   void factorize_lu_doolittle (void);
   void substitute_lu_crout (void);
   void substitute_lu_doolittle (void);
+  void substitute_lu_crout (tmatrix<nr_type_t> *, tmatrix<nr_type_t> *);
+  void substitute_lu_doolittle (tmatrix<nr_type_t> *, tmatrix<nr_type_t> *);
+  void solve_lu_sparse (void);
+  int  order_sparse (void);
+  int  reach_sparse (int, int, int, int *, int *, int *, int *);
+  void factorize_lu_sparse (void);
+  int  refactorize_lu_sparse (void);
+  void substitute_lu_sparse (void);
   void solve_qr (void);
   void solve_qr_ls (void);
   void solve_qrh (void);
@@ -126,6 +160,7 @@ class eqnsys
   void substitute_svd (void);
   void diagonalize_svd (void);
   void solve_iterative (void);
+  void solve_gmres (void);
   void solve_sor (void);
   nr_double_t convergence_criteria (void);
   void ensure_diagonal (void);
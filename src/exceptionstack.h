@@ -44,8 +44,10 @@ class exceptionstack
   exception * root;
 };
 
-// Global exception stack.
-extern exceptionstack estack;
+/* Global exception stack.  There is one instance per thread, thus
+   solvers running concurrently in different threads do not see each
+   other's exceptions. */
+extern thread_local exceptionstack estack;
 
 } /* namespace qucs */
 
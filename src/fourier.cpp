@@ -30,6 +30,10 @@
 #include <stdlib.h>
 #include <string.h>
 #include <cmath>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <vector>
 
 #include "consts.h"
 #include "object.h"
@@ -37,62 +41,322 @@
 #include "vector.h"
 #include "fourier.h"
 
-// Helper macro.
-#define Swap(a,b) { nr_double_t t; t = a; a = b; b = t; }
+// Largest number of cached transformation plans.
+#define FFT_PLANS 32
 
 namespace qucs {
 
 using namespace fourier;
 
+/* The transformation plan holds the factorization and the twiddle
+   factors for a certain length.  Lengths consisting of the factors 2,
+   3, 4 and 5 are transformed using a self-sorting mixed radix (Stockham)
+   algorithm.  All other lengths are turned into a convolution of
+   binary size (Bluestein's algorithm). */
+class fftplan
+{
+ public:
+  fftplan (int);
+  void execute (nr_double_t *, int) const;
+
+ private:
+  void stockham (nr_double_t *, nr_double_t *, int) const;
+  void bluestein (nr_double_t *) const;
+
+ private:
+  int n;
+  std::vector<int> radix;
+  std::vector<nr_double_t> twiddle; // exp (-2 pi i k / n)
+  std::vector<nr_double_t> chirp;   // exp (-pi i k^2 / n)
+  std::vector<nr_double_t> kernel;  // transformed conjugate chirp
+  std::unique_ptr<fftplan> conv;
+};
+
+// Constructor creates the transformation plan of the given length.
+fftplan::fftplan (int len) : n (len) {
+  int i, r = n;
+  // factorize the length, radix 4 first
+  while (r % 4 == 0) { radix.push_back (4); r /= 4; }
+  while (r % 2 == 0) { radix.push_back (2); r /= 2; }
+  while (r % 3 == 0) { radix.push_back (3); r /= 3; }
+  while (r % 5 == 0) { radix.push_back (5); r /= 5; }
+
+  if (r == 1) {
+    twiddle.resize (2 * n);
+    for (i = 0; i < n; i++) {
+      nr_double_t th = 2 * pi * i / n;
+      twiddle[2 * i] = cos (th);
+      twiddle[2 * i + 1] = -sin (th);
+    }
+    return;
+  }
+
+  // other prime factors require a convolution
+  radix.clear ();
+  int m = 2;
+  while (m < 2 * n - 1) m <<= 1;
+  conv.reset (new fftplan (m));
+  chirp.resize (2 * n);
+  kernel.assign (2 * m, 0.0);
+  for (i = 0; i < n; i++) {
+    // the angle is periodic in k^2 with 2n
+    long long k = ((long long) i * i) % (2 * n);
+    nr_double_t th = pi * k / n;
+    chirp[2 * i] = cos (th);
+    chirp[2 * i + 1] = -sin (th);
+    kernel[2 * i] = chirp[2 * i];
+    kernel[2 * i + 1] = -chirp[2 * i + 1];
+    if (i > 0) {
+      kernel[2 * (m - i)] = kernel[2 * i];
+      kernel[2 * (m - i) + 1] = kernel[2 * i + 1];
+    }
+  }
+  conv->execute (&kernel[0], 1);
+}
+
+/* The butterflies of the supported radices.  The sign 's' is +1 for the
+   forward and -1 for the inverse transformation. */
+template <int R> struct butterfly;
+
+template <> struct butterfly<2> {
+  static inline void run (nr_double_t * ar, nr_double_t * ai, nr_double_t) {
+    nr_double_t tr = ar[1], ti = ai[1];
+    ar[1] = ar[0] - tr; ai[1] = ai[0] - ti;
+    ar[0] += tr; ai[0] += ti;
+  }
+};
+
+template <> struct butterfly<3> {
+  static inline void run (nr_double_t * ar, nr_double_t * ai, nr_double_t s) {
+    const nr_double_t c = 0.86602540378443864676; // sqrt (3) / 2
+    nr_double_t t1r = ar[1] + ar[2], t1i = ai[1] + ai[2];
+    nr_double_t t2r = ar[1] - ar[2], t2i = ai[1] - ai[2];
+    nr_double_t mr = ar[0] - 0.5 * t1r, mi = ai[0] - 0.5 * t1i;
+    nr_double_t nr = s * c * t2i, ni = -s * c * t2r;
+    ar[0] += t1r; ai[0] += t1i;
+    ar[1] = mr + nr; ai[1] = mi + ni;
+    ar[2] = mr - nr; ai[2] = mi - ni;
+  }
+};
+
+template <> struct butterfly<4> {
+  static inline void run (nr_double_t * ar, nr_double_t * ai, nr_double_t s) {
+    nr_double_t t0r = ar[0] + ar[2], t0i = ai[0] + ai[2];
+    nr_double_t t1r = ar[0] - ar[2], t1i = ai[0] - ai[2];
+    nr_double_t t2r = ar[1] + ar[3], t2i = ai[1] + ai[3];
+    nr_double_t t3r = s * (ai[1] - ai[3]), t3i = -s * (ar[1] - ar[3]);
+    ar[0] = t0r + t2r; ai[0] = t0i + t2i;
+    ar[1] = t1r + t3r; ai[1] = t1i + t3i;
+    ar[2] = t0r - t2r; ai[2] = t0i - t2i;
+    ar[3] = t1r - t3r; ai[3] = t1i - t3i;
+  }
+};
+
+template <> struct butterfly<5> {
+  static inline void run (nr_double_t * ar, nr_double_t * ai, nr_double_t s) {
+    const nr_double_t c1 = 0.30901699437494742410;  // cos (2 pi / 5)
+    const nr_double_t c2 = -0.80901699437494742410; // cos (4 pi / 5)
+    const nr_double_t s1 = 0.95105651629515357212;  // sin (2 pi / 5)
+    const nr_double_t s2 = 0.58778525229247312917;  // sin (4 pi / 5)
+    nr_double_t t1r = ar[1] + ar[4], t1i = ai[1] + ai[4];
+    nr_double_t t2r = ar[2] + ar[3], t2i = ai[2] + ai[3];
+    nr_double_t t3r = ar[1] - ar[4], t3i = ai[1] - ai[4];
+    nr_double_t t4r = ar[2] - ar[3], t4i = ai[2] - ai[3];
+    nr_double_t m1r = ar[0] + c1 * t1r + c2 * t2r;
+    nr_double_t m1i = ai[0] + c1 * t1i + c2 * t2i;
+    nr_double_t m2r = ar[0] + c2 * t1r + c1 * t2r;
+    nr_double_t m2i = ai[0] + c2 * t1i + c1 * t2i;
+    nr_double_t n1r = s * (s1 * t3i + s2 * t4i), n1i = -s * (s1 * t3r + s2 * t4r);
+    nr_double_t n2r = s * (s2 * t3i - s1 * t4i), n2i = -s * (s2 * t3r - s1 * t4r);
+    ar[0] += t1r + t2r; ai[0] += t1i + t2i;
+    ar[1] = m1r + n1r; ai[1] = m1i + n1i;
+    ar[4] = m1r - n1r; ai[4] = m1i - n1i;
+    ar[2] = m2r + n2r; ai[2] = m2i + n2i;
+    ar[3] = m2r - n2r; ai[3] = m2i - n2i;
+  }
+};
+
+/* A single decimation in frequency pass of the Stockham algorithm.  It
+   transforms 's' interleaved sequences of length 'l' from 'x' into
+   'y' and applies the twiddle factors of the total length. */
+template <int R>
+static void fftstage (int l, int s, const nr_double_t * x, nr_double_t * y,
+		      const nr_double_t * w, nr_double_t sign) {
+  int m = l / R;
+  nr_double_t ar[R], ai[R];
+  for (int p = 0; p < m; p++) {
+    for (int q = 0; q < s; q++) {
+      int j, k;
+      for (j = 0; j < R; j++) {
+	const nr_double_t * src = &x[2 * (q + s * (p + j * m))];
+	ar[j] = src[0]; ai[j] = src[1];
+      }
+      butterfly<R>::run (ar, ai, sign);
+      nr_double_t * dst = &y[2 * (q + s * R * p)];
+      dst[0] = ar[0]; dst[1] = ai[0];
+      for (k = 1; k < R; k++) {
+	const nr_double_t * t = &w[2 * p * k * s];
+	nr_double_t wr = t[0], wi = sign * t[1];
+	dst[2 * s * k] = ar[k] * wr - ai[k] * wi;
+	dst[2 * s * k + 1] = ar[k] * wi + ai[k] * wr;
+      }
+    }
+  }
+}
+
+// Runs the passes of the mixed radix algorithm.
+void fftplan::stockham (nr_double_t * data, nr_double_t * work,
+			int isign) const {
+  nr_double_t sign = isign > 0 ? 1.0 : -1.0;
+  nr_double_t * x = data, * y = work;
+  int l = n, s = 1;
+  for (unsigned int i = 0; i < radix.size (); i++) {
+    switch (radix[i]) {
+    case 2: fftstage<2> (l, s, x, y, &twiddle[0], sign); break;
+    case 3: fftstage<3> (l, s, x, y, &twiddle[0], sign); break;
+    case 4: fftstage<4> (l, s, x, y, &twiddle[0], sign); break;
+    case 5: fftstage<5> (l, s, x, y, &twiddle[0], sign); break;
+    }
+    l /= radix[i];
+    s *= radix[i];
+    std::swap (x, y);
+  }
+  if (x != data) memcpy (data, x, 2 * n * sizeof (nr_double_t));
+}
+
+/* The forward transformation of arbitrary lengths computed by the
+   convolution of the chirp modulated data with the conjugate chirp. */
+void fftplan::bluestein (nr_double_t * data) const {
+  int i, m = conv->n;
+  std::vector<nr_double_t> a (2 * m, 0.0);
+  for (i = 0; i < 2 * n; i += 2) {
+    a[i] = data[i] * chirp[i] - data[i+1] * chirp[i+1];
+    a[i+1] = data[i] * chirp[i+1] + data[i+1] * chirp[i];
+  }
+  conv->execute (&a[0], 1);
+  for (i = 0; i < 2 * m; i += 2) {
+    nr_double_t r = a[i] * kernel[i] - a[i+1] * kernel[i+1];
+    a[i+1] = a[i] * kernel[i+1] + a[i+1] * kernel[i];
+    a[i] = r;
+  }
+  conv->execute (&a[0], -1);
+  for (i = 0; i < 2 * n; i += 2) {
+    data[i] = (a[i] * chirp[i] - a[i+1] * chirp[i+1]) / m;
+    data[i+1] = (a[i] * chirp[i+1] + a[i+1] * chirp[i]) / m;
+  }
+}
+
+/* Transforms the interleaved complex data in place.  The inverse
+   transformation (negative 'isign') is not normalized. */
+void fftplan::execute (nr_double_t * data, int isign) const {
+  int i;
+  if (n < 2) return;
+  if (conv) {
+    // the inverse is the conjugate transform of the conjugate data
+    if (isign < 0) for (i = 1; i < 2 * n; i += 2) data[i] = -data[i];
+    bluestein (data);
+    if (isign < 0) for (i = 1; i < 2 * n; i += 2) data[i] = -data[i];
+    return;
+  }
+  static thread_local std::vector<nr_double_t> work;
+  if ((int) work.size () < 2 * n) work.resize (2 * n);
+  stockham (data, &work[0], isign);
+}
+
+/* Returns the cached transformation plan for the given length.  The
+   plans are shared by all threads. */
+static std::shared_ptr<fftplan> getPlan (int n) {
+  static std::mutex lock;
+  static std::map<int, std::shared_ptr<fftplan> > plans;
+  std::lock_guard<std::mutex> guard (lock);
+  std::map<int, std::shared_ptr<fftplan> >::iterator it = plans.find (n);
+  if (it != plans.end ()) return it->second;
+  // drop the cached plans once too many lengths have been used
+  if (plans.size () >= FFT_PLANS) plans.clear ();
+  std::shared_ptr<fftplan> p (new fftplan (n));
+  plans[n] = p;
+  return p;
+}
+
 /* The function performs a 1-dimensional fast fourier transformation.
    Each data item is meant to be defined in equidistant steps.  The
-   number of data items needs to be of binary size, e.g. 64, 128. */
+   number of data items can be arbitrary, though lengths consisting of
+   the factors 2, 3 and 5 are transformed fastest. */
 void fourier::_fft_1d (nr_double_t * data, int len, int isign) {
+  getPlan (len)->execute (data, isign);
+}
 
-  // bit reversal method
-  int i, j, m, n;
-  n = 2 * len;
-  j = 0;
-  for (i = 0; i < n; i += 2) {
-    if (j > i) {                   // was index already swapped ?
-      Swap (data[j], data[i]);     // swap real part
-      Swap (data[j+1], data[i+1]); // swap imaginary part
-    }
-    m = len;
-    while (m >= 2 && j >= m) {     // calculate next swap index
-      j -= m;
-      m >>= 1;
-    }
-    j += m;
+/* The function transforms a real vector of the given length.  On return
+   the array contains the len / 2 + 1 complex values of the non-negative
+   frequencies, thus it must hold len + 2 items.  Even lengths are
+   transformed by a complex transformation of half the length. */
+void fourier::_rfft_1d (nr_double_t * data, int len) {
+  int k, n = len / 2;
+  if (len & 1) {
+    std::vector<nr_double_t> c (2 * len, 0.0);
+    for (k = 0; k < len; k++) c[2 * k] = data[k];
+    _fft_1d (&c[0], len, 1);
+    memcpy (data, &c[0], (len + 1) * sizeof (nr_double_t));
+    return;
   }
 
-  // Danielson-Lanzcos algorithm
-  int mmax, istep;
-  nr_double_t wt, th, wr, wi, wpr, wpi, ti, tr;
-  mmax = 2;
-  while (n > mmax) {
-    istep = mmax << 1;
-    th = isign * (2 * pi / mmax);
-    wt = sin (0.5 * th);
-    wpr = -2.0 * wt * wt;
-    wpi = sin (th);
-    wr = 1.0;
-    wi = 0.0;
-    for (m = 1; m < mmax; m += 2) {
-      for (i = m; i <= n; i += istep) {
-	j = i + mmax;
-	tr = wr * data[j] - wi * data[j-1];
-	ti = wr * data[j-1] + wi * data[j];
-	data[j] = data[i] - tr;
-	data[j-1] = data[i-1] - ti;
-	data[i] += tr;
-	data[i-1] += ti;
-      }
-      wr = (wt = wr) * wpr - wi * wpi + wr;
-      wi = wi * wpr + wt * wpi + wi;
+  // transform even and odd samples as real and imaginary parts
+  _fft_1d (data, n, 1);
+  data[2 * n] = data[0] - data[1];
+  data[2 * n + 1] = 0.0;
+  data[0] += data[1];
+  data[1] = 0.0;
+
+  // separate the two transforms and combine them
+  for (k = 1; 2 * k <= n; k++) {
+    int i = 2 * k, j = 2 * (n - k);
+    nr_double_t th = pi * k / n, wr = cos (th), wi = -sin (th);
+    nr_double_t er = 0.5 * (data[i] + data[j]);
+    nr_double_t ei = 0.5 * (data[i+1] - data[j+1]);
+    nr_double_t or_ = 0.5 * (data[i+1] + data[j+1]);
+    nr_double_t oi = -0.5 * (data[i] - data[j]);
+    nr_double_t tr = wr * or_ - wi * oi, ti = wr * oi + wi * or_;
+    data[i] = er + tr;
+    data[i+1] = ei + ti;
+    data[j] = er - tr;
+    data[j+1] = ti - ei;
+  }
+}
+
+/* This function is the inverse of the above real valued transformation.
+   It expects the len / 2 + 1 complex values of the non-negative
+   frequencies and returns len real values.  The result is not
+   normalized. */
+void fourier::_irfft_1d (nr_double_t * data, int len) {
+  int k, n = len / 2;
+  if (len & 1) {
+    std::vector<nr_double_t> c (2 * len);
+    memcpy (&c[0], data, (len + 1) * sizeof (nr_double_t));
+    for (k = n + 1; k < len; k++) {
+      c[2 * k] = data[2 * (len - k)];
+      c[2 * k + 1] = -data[2 * (len - k) + 1];
     }
-    mmax = istep;
+    _fft_1d (&c[0], len, -1);
+    for (k = 0; k < len; k++) data[k] = c[2 * k];
+    return;
   }
+
+  // recombine the spectra of the even and odd samples
+  nr_double_t r = data[0], q = data[2 * n];
+  data[0] = r + q;
+  data[1] = r - q;
+  for (k = 1; 2 * k <= n; k++) {
+    int i = 2 * k, j = 2 * (n - k);
+    nr_double_t th = pi * k / n, wr = cos (th), wi = sin (th);
+    nr_double_t er = data[i] + data[j], ei = data[i+1] - data[j+1];
+    nr_double_t dr = data[i] - data[j], di = data[i+1] + data[j+1];
+    nr_double_t or_ = wr * dr - wi * di, oi = wr * di + wi * dr;
+    data[i] = er - oi;
+    data[i+1] = ei + or_;
+    data[j] = er + oi;
+    data[j+1] = or_ - ei;
+  }
+  _fft_1d (data, n, -1);
 }
 
 /* The function transforms two real vectors using a single fast
@@ -211,14 +475,19 @@ void fourier::_dft_1d (nr_double_t * data, int len, int isign) {
    transformation on the given vector 'var'.  If 'sign' is -1 the
    inverse dft is computed, if +1 the dft itself is computed. */
 vector fourier::dft_1d (vector var, int isign) {
-  int k, n, len = var.getSize ();
+  int i, n, len = var.getSize ();
+  std::vector<nr_double_t> data (2 * len);
+  for (n = i = 0; i < len; i++, n += 2) {
+    data[n] = real (var (i)); data[n+1] = imag (var (i));
+  }
+
+  // any length is transformed by the fast algorithm
+  if (len > 0) _fft_1d (&data[0], len, isign);
+
   vector res = vector (len);
-  for (n = 0; n < len; n++) {
-    nr_double_t th = - isign * 2 * pi * n / len;
-    nr_complex_t val = 0;
-    for (k = 0; k < len; k++)
-      val += var (k) * std::polar (1.0, th * k);
-    res (n) = isign < 0 ? val / (nr_double_t) len : val;
+  for (n = i = 0; i < len; i++, n += 2) {
+    res (i) = nr_complex_t (data[n], data[n+1]);
+    if (isign < 0) res (i) /= len;
   }
   return res;
 }
@@ -239,74 +508,42 @@ void fourier::_idft_1d (nr_double_t * data, int len) {
 
 /* The function performs a n-dimensional fast fourier transformation.
    Each data item is meant to be defined in equidistant steps.  The
-   number of data items needs to be of binary size, e.g. 64, 128 for
-   each dimension. */
+   last dimension is stored contiguously.  The dimensions are
+   transformed one after another along each line of data items. */
 void fourier::_fft_nd (nr_double_t * data, int len[], int nd, int isign) {
 
- int i, i1, i2, i3, i2rev, i3rev, ip1, ip2, ip3, ifp1, ifp2;
- int ibit, k1, k2, n, np, nr, nt;
-
- // compute total number of complex values
- for (nt = 1, i = 0; i < nd; i++) nt *= len[i];
-
- // main loop over the dimensions
- for (np = 1, i = nd - 1; i >= 0; i--) {
-   n = len[i];
-   nr = nt / (n * np);
-   ip1 = np << 1;
-   ip2 = ip1 * n;
-   ip3 = ip2 * nr;
-
-   // bit-reversal method
-   for (i2rev = 1, i2 = 1; i2 <= ip2; i2 += ip1) {
-     if (i2 < i2rev) {
-       for (i1 = i2; i1 <= i2 + ip1 - 2; i1 += 2) {
-	 for (i3 = i1; i3 <= ip3; i3 += ip2) {
-	   i3rev = i2rev + i3 - i2;
-	   Swap (data[i3-1], data[i3rev-1]);
-	   Swap (data[i3], data[i3rev]);
-	 }
-       }
-     }
-     ibit = ip2 >> 1;
-     while (ibit >= ip1 && i2rev > ibit) {
-       i2rev -= ibit;
-       ibit >>= 1;
-     }
-     i2rev += ibit;
-   }
-
-   // Danielson-Lanzcos algorithm
-   nr_double_t ti, tr, wt, th, wr, wi, wpi, wpr;
-   ifp1 = ip1;
-   while (ifp1 < ip2) {
-     ifp2 = ifp1 << 1;
-     th = isign * 2 * pi / (ifp2 / ip1);
-     wt = sin (0.5 * th);
-     wpr = -2.0 * wt * wt;
-     wpi = sin (th);
-     wr = 1.0;
-     wi = 0.0;
-     for (i3 = 1; i3 <= ifp1; i3 += ip1) {
-       for (i1 = i3; i1 <= i3 + ip1 - 2; i1 += 2) {
-	 for (i2 = i1; i2 <= ip3; i2 += ifp2) {
-	   k1 = i2;
-	   k2 = k1 + ifp1;
-	   tr = wr * data[k2-1] - wi * data[k2];
-	   ti = wr * data[k2] + wi * data[k2-1];
-	   data[k2-1] = data[k1-1] - tr;
-	   data[k2] = data[k1] - ti;
-	   data[k1-1] += tr;
-	   data[k1] += ti;
-	 }
-       }
-       wr = (wt = wr) * wpr - wi * wpi + wr;
-       wi = wi * wpr + wt * wpi + wi;
-     }
-     ifp1 = ifp2;
-   }
-   np *= n;
- }
+  int i, k, l, n, nt, np;
+
+  // compute total number of complex values
+  for (nt = 1, i = 0; i < nd; i++) nt *= len[i];
+
+  // main loop over the dimensions
+  for (np = 1, i = nd - 1; i >= 0; i--) {
+    n = len[i];
+    if (np == 1) {
+      // contiguous lines
+      for (l = 0; l < nt; l += n) _fft_1d (&data[2 * l], n, isign);
+    }
+    else {
+      // gather each strided line, transform and scatter it again
+      std::vector<nr_double_t> line (2 * n);
+      for (int o = 0; o < nt; o += n * np) {
+	for (int q = 0; q < np; q++) {
+	  nr_double_t * src = &data[2 * (o + q)];
+	  for (k = 0; k < n; k++) {
+	    line[2 * k] = src[2 * k * np];
+	    line[2 * k + 1] = src[2 * k * np + 1];
+	  }
+	  _fft_1d (&line[0], n, isign);
+	  for (k = 0; k < n; k++) {
+	    src[2 * k * np] = line[2 * k];
+	    src[2 * k * np + 1] = line[2 * k + 1];
+	  }
+	}
+      }
+    }
+    np *= n;
+  }
 }
 
 // Helper functions.
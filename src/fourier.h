@@ -46,6 +46,9 @@ namespace fourier {
   void  _dft_1d (nr_double_t *, int, int isign = 1);
   void _idft_1d (nr_double_t *, int);
 
+  void  _rfft_1d (nr_double_t *, int);
+  void _irfft_1d (nr_double_t *, int);
+
   void  _fft_1d_2r (nr_double_t *, nr_double_t *, int);
   void _ifft_1d_2r (nr_double_t *, nr_double_t *, int);
 
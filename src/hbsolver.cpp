@@ -29,6 +29,7 @@
 #include<algorithm>
 
 #include <stdio.h>
+#include <string.h>
 
 #include "object.h"
 #include "logging.h"
@@ -47,6 +48,7 @@
 #include "analysis.h"
 #include "dataset.h"
 #include "fourier.h"
+#include "threadpool.h"
 #include "hbsolver.h"
 
 #define HB_DEBUG 0
@@ -65,7 +67,10 @@ hbsolver::hbsolver () : analysis () {
   OM = IR = QR = RH = IG = FQ = VS = VP = FV = IL = IN = IC = IS = NULL;
   vs = x = NULL;
   runs = 0;
+  eqnAlgo = ALGO_LU_DECOMPOSITION;
   ndfreqs = NULL;
+  threads = 1;
+  pool = NULL;
 }
 
 // Constructor creates a named instance of the hbsolver class.
@@ -78,7 +83,10 @@ hbsolver::hbsolver (char * n) : analysis (n) {
   OM = IR = QR = RH = IG = FQ = VS = VP = FV = IL = IN = IC = IS = NULL;
   vs = x = NULL;
   runs = 0;
+  eqnAlgo = ALGO_LU_DECOMPOSITION;
   ndfreqs = NULL;
+  threads = 1;
+  pool = NULL;
 }
 
 // Destructor deletes the hbsolver class object.
@@ -119,6 +127,7 @@ hbsolver::~hbsolver () {
 
   delete x;
   delete[] ndfreqs;
+  delete pool;
 }
 
 /* The copy constructor creates a new instance of the hbsolver class
@@ -136,7 +145,10 @@ hbsolver::hbsolver (hbsolver & o) : analysis (o) {
   OM = IR = QR = RH = IG = FQ = VS = VP = FV = IL = IN = IC = IS = NULL;
   vs = x = NULL;
   runs = o.runs;
+  eqnAlgo = o.eqnAlgo;
   ndfreqs = NULL;
+  threads = o.threads;
+  pool = NULL;
 }
 
 #define VS_(r) (*VS) (r)
@@ -148,6 +160,14 @@ int hbsolver::solve (void) {
 
   int iterations = 0, done = 0;
   int MaxIterations = getPropertyInteger ("MaxIter");
+  const char * const solver = getPropertyString ("Solver");
+  threads = getPropertyInteger ("Threads");
+
+  // choose a solver for the Newton steps
+  if (!strcmp (solver, "GMRES"))
+    eqnAlgo = ALGO_GMRES;
+  else
+    eqnAlgo = ALGO_LU_DECOMPOSITION;
 
   // collect different parts of the circuit
   splitCircuits ();
@@ -174,6 +194,13 @@ int hbsolver::solve (void) {
     // prepares the non-linear part
     prepareNonLinear ();
 
+    // the node blocks can be transformed concurrently
+    if (threads > 1 && nbanodes > 1) {
+      pool = new threadpool (threads);
+      logprint (LOG_STATUS, "NOTIFY: %s: using %d threads\n", getName (),
+		threads);
+    }
+
 #if HB_DEBUG
       fprintf (stderr, "YV -- transY in f:\n"); YV->print ();
       fprintf (stderr, "IC -- constant current in f:\n"); IC->print ();
@@ -265,6 +292,9 @@ int hbsolver::solve (void) {
     // check termination criteria (balanced frequency domain currents)
     while (!done && iterations < MaxIterations);
 
+    delete pool;
+    pool = NULL;
+
     if (iterations >= MaxIterations) {
       qucs::exception * e = new qucs::exception (EXCEPTION_NO_CONVERGENCE);
       e->setText ("no convergence in %s analysis after %d iterations",
@@ -309,6 +339,7 @@ void hbsolver::calc (hbsolver * self) {
 void hbsolver::initHB (void) {
   circuit * root = subnet->getRoot ();
   for (circuit * c = root; c != NULL; c = (circuit *) c->getNext ()) {
+    c->setRealMNA (false);
     c->initHB ();
   }
 }
@@ -318,6 +349,7 @@ void hbsolver::initHB (void) {
 void hbsolver::initDC (void) {
   circuit * root = subnet->getRoot ();
   for (circuit * c = root; c != NULL; c = (circuit *) c->getNext ()) {
+    c->setRealMNA (true);
     c->initDC ();
   }
 }
@@ -549,8 +581,10 @@ int hbsolver::assignNodes (ptrlist<circuit> circuits, strlist * nodes,
 
 // Prepares the linear operations.
 void hbsolver::prepareLinear (void) {
-  for (auto *lc : lincircuits)
+  for (auto *lc : lincircuits) {
+    lc->setRealMNA (false);
     lc->initHB ();
+  }
   nlnvsrcs = assignVoltageSources (lincircuits);
   nnlvsrcs = excitations.size ();
   nnanodes = nanodes->length ();
@@ -655,13 +689,11 @@ void hbsolver::invertMatrix (tmatrix<nr_complex_t> * A,
 			     tmatrix<nr_complex_t> * H) {
   eqnsys<nr_complex_t> eqns;
   int N = A->getCols ();
-  tvector<nr_complex_t> * x = new tvector<nr_complex_t> (N);
-  tvector<nr_complex_t> * z = new tvector<nr_complex_t> (N);
 
   try_running () {
     // create LU decomposition of the A matrix
     eqns.setAlgo (ALGO_LU_FACTORIZATION_CROUT);
-    eqns.passEquationSys (A, x, z);
+    eqns.passEquationSys (A, NULL, NULL);
     eqns.solve ();
   }
   // appropriate exception handling
@@ -672,17 +704,11 @@ void hbsolver::invertMatrix (tmatrix<nr_complex_t> * A,
     estack.print ();
   }
 
-  // use the LU decomposition to obtain the inverse H
+  // use the LU decomposition to obtain the inverse H, all columns of
+  // the identity matrix are substituted at once
+  tmatrix<nr_complex_t> E = teye<nr_complex_t> (N);
   eqns.setAlgo (ALGO_LU_SUBSTITUTION_CROUT);
-  for (int c = 0; c < N; c++) {
-    z->set (0.0);
-    z->set (c, 1.0);
-    eqns.passEquationSys (A, x, z);
-    eqns.solve ();
-    for (int r = 0; r < N; r++) H->set (r, c, x->get (r));
-  }
-  delete x;
-  delete z;
+  eqns.solve (H, &E);
 }
 
 // Some defines for matrix element access.
@@ -773,13 +799,14 @@ void hbsolver::createMatrixLinearY (void) {
     estack.print ();
   }
 
-  // acquire variable transimpedance matrix entries
+  // acquire variable transimpedance matrix entries, substitute the
+  // unit excitations of all balanced nodes at once
+  tmatrix<nr_complex_t> VV (sa, sn), II (sa, sn);
+  for (c = 0; c < sn; c++) II (c, c) = 1.0;
   eqns.setAlgo (ALGO_LU_SUBSTITUTION_CROUT);
+  eqns.solve (&VV, &II);
   for (c = 0; c < sn; c++) {
-    I->set (0.0);
-    I_(c) = 1.0;
-    eqns.passEquationSys (A, V, I);
-    eqns.solve ();
+    *V = VV.getCol (c);
     // ZV | ..
     // ---+---
     // .. | ..
@@ -880,6 +907,7 @@ void hbsolver::calcConstantCurrent (void) {
   tvector<nr_complex_t> VC (se);
   for (auto it = excitations.begin(); it != excitations.end(); ++it, vsrc++) {
     circuit * vs = *it;
+    vs->setRealMNA (false);
     vs->initHB ();
     vs->setVoltageSource (0);
     for (int f = 0; f < rfreqs.size (); f++) { // for each frequency
@@ -968,16 +996,17 @@ void hbsolver::fillMatrixNonLinear (tmatrix<nr_complex_t> * jg,
 				    tvector<nr_complex_t> * ir,
 				    tvector<nr_complex_t> * qr,
 				    int f) {
-  // through each linear circuit
-  for (auto *cir: nolcircuits) {
+  // through each non-linear circuit
+  for (int i = 0; i < nltopo.getCircuits (); i++) {
+    circuit * cir = nltopo.getCircuit (i);
     int s = cir->getSize ();
     int nr, nc, r, c;
 
     for (r = 0; r < s; r++) {
-      if ((nr = cir->getNode(r)->getNode () - 1) < 0) continue;
+      if ((nr = nltopo.getNode (i, r)) < 0) continue;
       // apply G- and C-matrix entries
       for (c = 0; c < s; c++) {
-	if ((nc = cir->getNode(c)->getNode () - 1) < 0) continue;
+	if ((nc = nltopo.getNode (i, c)) < 0) continue;
 	G_(nr, nc) += cir->getY (r, c);
 	C_(nr, nc) += cir->getQV (r, c);
       }
@@ -1048,19 +1077,23 @@ void hbsolver::prepareNonLinear (void) {
 
   // assign nodes
   assignNodes (nolcircuits, nanodes);
+  nltopo.create (nolcircuits);
 
-  // initialize circuits
+  // initialize circuits, evaluated in the time domain
   for (auto *cir : nolcircuits) {
+    cir->setRealMNA (true);
     cir->initHB (nlfreqs);
   }
 }
 
-/* Saves the node voltages of the given circuit and for the given
-   frequency entry into the circuit voltage vector. */
-void hbsolver::saveNodeVoltages (circuit * cir, int f) {
+/* Saves the node voltages of the non-linear circuit with the given
+   index and for the given frequency entry into the circuit voltage
+   vector. */
+void hbsolver::saveNodeVoltages (int i, int f) {
+  circuit * cir = nltopo.getCircuit (i);
   int r, nr, s = cir->getSize ();
   for (r = 0; r < s; r++) {
-    if ((nr = cir->getNode(r)->getNode () - 1) < 0) continue;
+    if ((nr = nltopo.getNode (i, r)) < 0) continue;
     // apply V-vector entries
     cir->setV (r, real (vs->get (nr * nlfreqs + f)));
   }
@@ -1080,9 +1113,9 @@ void hbsolver::loadMatrices (void) {
   // through each frequency
   for (int f = 0; f < nlfreqs; f++) {
     // calculate components' HB matrices and vector for the given frequency
-    for (auto *cir : nolcircuits) {
-      saveNodeVoltages (cir, f); // node voltages
-      cir->calcHB (f);         // HB calculator
+    for (int i = 0; i < nltopo.getCircuits (); i++) {
+      saveNodeVoltages (i, f);            // node voltages
+      nltopo.getCircuit (i)->calcHB (f);  // HB calculator
     }
     // fill in all matrix entries for the given frequency
     fillMatrixNonLinear (JG, JQ, IG, FQ, IR, QR, f);
@@ -1094,28 +1127,30 @@ void hbsolver::loadMatrices (void) {
    \todo rewrite ugly should die
 */
 void hbsolver::VectorFFT (tvector<nr_complex_t> * V, int isign) {
-  int i, k, r;
   int n = nlfreqs;
   int nd = dfreqs.size ();
   int nodes = V->size () / n;
   nr_double_t * d = (double *)V->getData ();
 
-  if (nd == 1) {
-    // for each node a single 1d-FFT
-    for (k = i = 0; i < nodes; i++, k += 2 * n) {
-      nr_double_t * dst = &d[k];
-      _fft_1d (dst, n, isign);
-      if (isign > 0) for (r = 0; r < 2 * n; r++) *dst++ /= n;
+  runBlocks (nodes, [&] (int from, int to) {
+    int i, r;
+    if (nd == 1) {
+      // for each node a single 1d-FFT
+      for (i = from; i < to; i++) {
+	nr_double_t * dst = &d[2 * n * i];
+	_fft_1d (dst, n, isign);
+	if (isign > 0) for (r = 0; r < 2 * n; r++) *dst++ /= n;
+      }
     }
-  }
-  else {
-    // for each node a single nd-FFT
-    for (k = i = 0; i < nodes; i++, k += 2 * n) {
-      nr_double_t * dst = &d[k];
-      _fft_nd (dst, ndfreqs, nd, isign);
-      if (isign > 0) for (r = 0; r < 2 * n; r++) *dst++ /= ndfreqs[0];
+    else {
+      // for each node a single nd-FFT
+      for (i = from; i < to; i++) {
+	nr_double_t * dst = &d[2 * n * i];
+	_fft_nd (dst, ndfreqs, nd, isign);
+	if (isign > 0) for (r = 0; r < 2 * n; r++) *dst++ /= ndfreqs[0];
+      }
     }
-  }
+  });
 }
 
 /* The following function transforms a vector using an Inverse Fast
@@ -1144,24 +1179,26 @@ void hbsolver::MatrixFFT (tmatrix<nr_complex_t> * M) {
     M->setRow (r, V);
   }
 #else
-  int c, r, nc, nr;
-  // for each non-linear node block
-  for (nc = c = 0; c < nbanodes; c++, nc += nlfreqs) {
-    for (nr = r = 0; r < nbanodes; r++, nr += nlfreqs) {
-      tvector<nr_complex_t> V (nlfreqs);
-      int fr, fc, fi;
-      // transform the sub-diagonal only
-      for (fc = 0; fc < nlfreqs; fc++) V (fc) = M->get (nr + fc, nc + fc);
-      VectorFFT (&V);
-      // fill in resulting sub-matrix for the node
-      for (fc = 0; fc < nlfreqs; fc++) {
-	for (fi = nlfreqs - 1 - fc, fr = 0; fr < nlfreqs; fr++) {
-	  if (++fi >= nlfreqs) fi = 0;
-	  M->set (nr + fr, nc + fc, V (fi));
+  // for each column of non-linear node blocks
+  runBlocks (nbanodes, [&] (int from, int to) {
+    int c, r, nc, nr;
+    tvector<nr_complex_t> V (nlfreqs);
+    for (nc = from * nlfreqs, c = from; c < to; c++, nc += nlfreqs) {
+      for (nr = r = 0; r < nbanodes; r++, nr += nlfreqs) {
+	int fr, fc, fi;
+	// transform the sub-diagonal only
+	for (fc = 0; fc < nlfreqs; fc++) V (fc) = M->get (nr + fc, nc + fc);
+	VectorFFT (&V);
+	// fill in resulting sub-matrix for the node
+	for (fc = 0; fc < nlfreqs; fc++) {
+	  for (fi = nlfreqs - 1 - fc, fr = 0; fr < nlfreqs; fr++) {
+	    if (++fi >= nlfreqs) fi = 0;
+	    M->set (nr + fr, nc + fc, V (fi));
+	  }
 	}
       }
     }
-  }
+  });
 #endif
 }
 
@@ -1175,52 +1212,76 @@ void hbsolver::MatrixFFT (tmatrix<nr_complex_t> * M) {
    Also the right hand side of the equation system for the new voltage
    vector is computed here. */
 void hbsolver::solveHB (void) {
+  int n = nbanodes * nlfreqs;
   // for each non-linear node
-  for (int r = 0; r < nbanodes * nlfreqs; ) {
-    // for each frequency
-    for (int f = 0; f < nlfreqs; f++, r++) {
-      nr_complex_t il = 0.0, in = 0.0, ir = 0.0;
-      // constant current vector due to sources
-      il += IC->get (r);
-      // part 1 of right hand side vector
-      ir -= il;
-      // transadmittance matrix multiplied by voltage vector
-      for (int c = 0; c < nbanodes * nlfreqs; c++) {
-	il += YV_(r, c) * VS_(c);
+  runBlocks (nbanodes, [&] (int from, int to) {
+    nr_complex_t * yv = YV->getData () + from * nlfreqs * n;
+    nr_complex_t * v = VS->getData ();
+    for (int r = from * nlfreqs; r < to * nlfreqs; ) {
+      // for each frequency
+      for (int f = 0; f < nlfreqs; f++, r++, yv += n) {
+	nr_complex_t il = 0.0, in = 0.0, ir = 0.0;
+	// constant current vector due to sources
+	il += IC->get (r);
+	// part 1 of right hand side vector
+	ir -= il;
+	// transadmittance matrix multiplied by voltage vector
+	for (int c = 0; c < n; c++) {
+	  il += yv[c] * v[c];
+	}
+	// charge vector
+	in += OM_(f) * FQ->get (r);
+	// current vector
+	in += IG->get (r);
+	// part 2, 3 and 4 of right hand side vector
+	ir += IR->get (r);
+	ir += OM_(f) * QR->get (r);
+	// put values into result vectors
+	RH->set (r, ir);
+	FV->set (r, il + in);
+	IL->set (r, il);
+	IN->set (r, in);
       }
-      // charge vector
-      in += OM_(f) * FQ->get (r);
-      // current vector
-      in += IG->get (r);
-      // part 2, 3 and 4 of right hand side vector
-      ir += IR->get (r);
-      ir += OM_(f) * QR->get (r);
-      // put values into result vectors
-      RH->set (r, ir);
-      FV->set (r, il + in);
-      IL->set (r, il);
-      IN->set (r, in);
     }
-  }
+  });
 }
 
-/* The function calculates the full Jacobian JF = [YV] + j[O] * JQ + JG */
+/* The function calculates the full Jacobian JF = [YV] + j[O] * JQ + JG
+   row by row. */
 void hbsolver::calcJacobian (void) {
-  int c, r, fc, fr, rt, ct;
+  int n = nbanodes * nlfreqs;
   /* add admittances of capacitance matrix JQ and non-linear
-     admittances matrix JG into complete Jacobian JF */
-  for (c = 0; c < nbanodes; c++) {
-    ct = c * nlfreqs;
-    for (fc = 0; fc < nlfreqs; fc++, ct++) {
-      for (r = 0; r < nbanodes; r++) {
-	rt = r * nlfreqs;
-	for (fr = 0; fr < nlfreqs; fr++, rt++) {
-	  JF_(rt, ct) = JG->get (rt, ct) + JQ->get (rt, ct) * OM_(fr);
+     admittances matrix JG and the linear admittance matrix YV into
+     complete Jacobian JF */
+  runBlocks (nbanodes, [&] (int from, int to) {
+    int o = from * nlfreqs * n;
+    nr_complex_t * jf = JF->getData () + o, * jg = JG->getData () + o;
+    nr_complex_t * jq = JQ->getData () + o, * yv = YV->getData () + o;
+    for (int rt = from * nlfreqs; rt < to * nlfreqs; ) {
+      for (int fr = 0; fr < nlfreqs; fr++, rt++) {
+	nr_complex_t om = OM_(fr);
+	for (int ct = 0; ct < n; ct++) {
+	  *jf++ = (*jg++ + *jq++ * om) + *yv++;
 	}
       }
     }
-  }
-  *JF += *YV; // add linear admittance matrix
+  });
+}
+
+/* The function runs the given task for the node blocks [from,to) of
+   the HB equation system.  With a thread pool the blocks are split
+   into a few ranges per thread.  Each block writes its own matrix and
+   vector entries only, thus the results do not depend on the number
+   of threads. */
+void hbsolver::runBlocks (int n, const std::function<void (int, int)> & f) {
+  if (pool == NULL || n < 2) {
+    f (0, n);
+    return;
+  }
+  int k = std::min (n, pool->getThreads () * 4);
+  pool->run (k, [&] (int i) {
+    f ((int) ((long) n * i / k), (int) ((long) n * (i + 1) / k));
+  });
 }
 
 /* The function expands the given vector in the frequency domain to
@@ -1279,8 +1340,8 @@ void hbsolver::solveVoltages (void) {
   // setup equation system
   eqnsys<nr_complex_t> eqns;
   try_running () {
-    // use LU decomposition for solving
-    eqns.setAlgo (ALGO_LU_DECOMPOSITION);
+    // use LU decomposition or GMRES for solving
+    eqns.setAlgo (eqnAlgo);
     eqns.passEquationSys (JF, VS, RH);
     eqns.solve ();
   }
@@ -1425,6 +1486,9 @@ PROP_OPT [] = {
   { "vabstol", PROP_REAL, { 1e-6, PROP_NO_STR }, PROP_RNG_X01I },
   { "reltol", PROP_REAL, { 1e-3, PROP_NO_STR }, PROP_RNG_X01I },
   { "MaxIter", PROP_INT, { 150, PROP_NO_STR }, PROP_RNGII (2, 10000) },
+  { "Solver", PROP_STR, { PROP_NO_VAL, "CroutLU" },
+    PROP_RNG_STR2 ("CroutLU", "GMRES") },
+  { "Threads", PROP_INT, { 1, PROP_NO_STR }, PROP_MIN_VAL (1) },
   PROP_NO_PROP };
 struct define_t hbsolver::anadef =
   { "HB", 0, PROP_ACTION, PROP_NO_SUBSTRATE, PROP_LINEAR, PROP_DEF };
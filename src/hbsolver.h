@@ -26,15 +26,18 @@
 #define __HBSOLVER_H__
 
 #include <vector>
+#include <functional>
 
 #include "ptrlist.h"
 #include "tvector.h"
+#include "topology.h"
 
 namespace qucs {
 
 class vector;
 class strlist;
 class circuit;
+class threadpool;
 
 class hbsolver : public analysis
 {
@@ -84,7 +87,8 @@ class hbsolver : public analysis
   tmatrix<nr_complex_t> extendMatrixLinear (tmatrix<nr_complex_t>, int);
   void fillMatrixLinearExtended (tmatrix<nr_complex_t> *,
 				 tvector<nr_complex_t> *);
-  void saveNodeVoltages (circuit *, int);
+  void saveNodeVoltages (int, int);
+  void runBlocks (int, const std::function<void (int, int)> &);
 
  private:
   std::vector<nr_double_t> negfreqs;    // full frequency set
@@ -96,6 +100,7 @@ class hbsolver : public analysis
   strlist * nlnodes, * lnnodes, * banodes, * nanodes, * exnodes;
   ptrlist<circuit> excitations;
   ptrlist<circuit> nolcircuits;
+  topology nltopo;
   ptrlist<circuit> lincircuits;
 
   tmatrix<nr_complex_t> * Y;  // transadmittance matrix of linear network
@@ -127,6 +132,7 @@ class hbsolver : public analysis
   tvector<nr_complex_t> * vs;
 
   int runs;
+  int eqnAlgo;
   int lnfreqs;
   int nlfreqs;
   int nnlvsrcs;
@@ -135,6 +141,8 @@ class hbsolver : public analysis
   int nnanodes;
   int nexnodes;
   int nbanodes;
+  int threads;
+  threadpool * pool;
 };
 
 } // namespace qucs
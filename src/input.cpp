@@ -31,6 +31,7 @@
 #include <string.h>
 #include <errno.h>
 #include <assert.h>
+#include <vector>
 
 #include "logging.h"
 #include "component.h"
@@ -53,8 +54,11 @@ int netlist_check = 0;
 // Constructor creates an unnamed instance of the input class.
 input::input () : object () {
   fd = stdin;
+  buffer = NULL;
+  length = 0;
   subnet = NULL;
   env = NULL;
+  defs = netlist_create ();
 }
 
 // Constructor creates an named instance of the input class.
@@ -64,49 +68,67 @@ input::input (char * file) : object (file) {
 	      file, strerror (errno));
     fd = stdin;
   }
+  buffer = NULL;
+  length = 0;
   subnet = NULL;
   env = NULL;
+  defs = netlist_create ();
 }
 
 // Destructor deletes an input object.
 input::~input () {
   if (fd != stdin) fclose (fd);
+  netlist_free (defs);
+}
+
+/* The function passes a netlist in memory to the input object.  The
+   netlist is then read from the given buffer instead of the input
+   file.  The buffer must remain valid until the netlist is parsed. */
+void input::setBuffer (const char * buf, int len) {
+  buffer = buf;
+  length = len;
 }
 
 /* This function scans, parses and checks a netlist from the input
-   file (specified by the constructor call) or stdin if there is no
-   such file.  Afterwards the function builds the netlist
+   buffer, the input file (specified by the constructor call) or stdin
+   if there is no such file.  Afterwards the function builds the netlist
    representation and stores it into the given netlist object.  The
    function returns zero on success and non-zero otherwise. */
 int input::netlist (net * netlist) {
 
-  // tell the scanner to use the specified file
-  netlist_in = getFile ();
-
   // save the netlist object
   subnet = netlist;
 
   logprint (LOG_STATUS, "parsing netlist...\n");
 
-  if (netlist_parse () != 0)
+  // tell the scanner to use the specified buffer or file
+  if (buffer != NULL) {
+    if (netlist_parse_buffer (defs, buffer, length) != 0)
+      return -1;
+  }
+  else if (netlist_parse_file (defs, getFile ()) != 0)
     return -1;
 
   logprint (LOG_STATUS, "checking netlist...\n");
-  if (netlist_checker (env) != 0)
+  if (netlist_checker (defs, env) != 0)
     return -1;
 
-  if (netlist_checker_variables (env) != 0)
+  if (netlist_checker_variables (defs, env) != 0)
     return -1;
 
 #if DEBUG
-  netlist_list ();
+  netlist_list (defs);
 #endif /* DEBUG */
-  netlist_status ();
+  netlist_status (defs);
 
   logprint (LOG_STATUS, "creating netlist...\n");
   factory ();
 
-  netlist_destroy ();
+  // keep the subcircuit definitions until the instances are created
+  if (instances.empty ())
+    netlist_destroy (defs);
+  else
+    subnet->setDeferred (this);
   return 0;
 }
 
@@ -123,17 +145,11 @@ qucs::vector * input::createVector (struct value_t * values) {
 void input::factory (void) {
 
   struct definition_t * def, * next;
-  struct node_t * nodes;
   struct pair_t * pairs;
-  circuit * c;
-  object * o;
   analysis * a;
-  substrate * s;
-  nodeset * n;
-  int i;
 
   // go through the list of input definitions
-  for (def = definition_root; def != NULL; def = next) {
+  for (def = defs->definition_root; def != NULL; def = next) {
     next = def->next;
     // handle actions
     if (def->action) {
@@ -177,12 +193,30 @@ void input::factory (void) {
 	subnet->insertAnalysis (a);
       }
       // remove this definition from the list
-      definition_root = netlist_unchain_definition (definition_root, def);
+      defs->definition_root =
+        netlist_unchain_definition (defs->definition_root, def);
     }
   }
 
+  // create the substrates and nodesets, put the subcircuit instances
+  // aside and finally create the remaining circuits
+  defs->definition_root = factorySubstrates (defs->definition_root);
+  deferSubcircuits ();
+  defs->definition_root = factoryCircuits (defs->definition_root);
+}
+
+/* The function creates the substrates and nodesets of the given list
+   of definitions.  It returns the list with these definitions
+   removed. */
+struct definition_t * input::factorySubstrates (struct definition_t * root) {
+
+  struct definition_t * def, * next;
+  struct pair_t * pairs;
+  substrate * s;
+  nodeset * n;
+
   // go through the list of input definitions
-  for (def = definition_root; def != NULL; def = next) {
+  for (def = root; def != NULL; def = next) {
     next = def->next;
     // handle substrate definitions
     if (!def->action && def->substrate) {
@@ -216,7 +250,7 @@ void input::factory (void) {
 	def->env->addVariable (v);
       }
       // remove this definition from the list
-      definition_root = netlist_unchain_definition (definition_root, def);
+      root = netlist_unchain_definition (root, def);
     }
     // handle nodeset definitions
     else if (!def->action && def->nodeset) {
@@ -225,12 +259,25 @@ void input::factory (void) {
       n->setValue (def->pairs->value->value);
       subnet->addNodeset (n);
       // remove this definition from the list
-      definition_root = netlist_unchain_definition (definition_root, def);
+      root = netlist_unchain_definition (root, def);
     }
   }
+  return root;
+}
+
+/* The function creates the circuits of the given list of definitions.
+   It returns the list with these definitions removed. */
+struct definition_t * input::factoryCircuits (struct definition_t * root) {
+
+  struct definition_t * def, * next;
+  struct node_t * nodes;
+  struct pair_t * pairs;
+  circuit * c;
+  object * o;
+  int i;
 
   // go through the list of input definitions
-  for (def = definition_root; def != NULL; def = next) {
+  for (def = root; def != NULL; def = next) {
     next = def->next;
     // handle component definitions
     if (!def->action && !def->substrate && !def->nodeset) {
@@ -296,9 +343,52 @@ void input::factory (void) {
       subnet->insertCircuit (c);
 
       // remove this definition from the list
-      definition_root = netlist_unchain_definition (definition_root, def);
+      root = netlist_unchain_definition (root, def);
+    }
+  }
+  return root;
+}
+
+/* The function detaches the subcircuit instances from the list of
+   definitions.  Their circuits are not created until an analysis
+   needs them, see factorySubcircuits(). */
+void input::deferSubcircuits (void) {
+
+  struct definition_t * def, * next, * prev = NULL;
+
+  for (def = defs->definition_root; def != NULL; def = next) {
+    next = def->next;
+    if (!def->action && !strcmp (def->type, "Sub")) {
+      if (prev)
+	prev->next = next;
+      else
+	defs->definition_root = next;
+      def->next = NULL;
+      instances.push_back (def);
     }
+    else prev = def;
+  }
+}
+
+/* This function expands the deferred subcircuit instances one after
+   another and creates their substrates and circuits.  Thus only the
+   definitions of a single instance exist at a time.  The instances
+   are handled in reverse order, as used by the former expansion of all
+   subcircuits in the checker.  Afterwards the shared subcircuit
+   definitions are released. */
+void input::factorySubcircuits (void) {
+
+  logprint (LOG_STATUS, "creating subcircuit instances...\n");
+  for (auto it = instances.rbegin (); it != instances.rend (); ++it) {
+    struct definition_t * root = netlist_expand_subcircuit (defs, *it);
+    root = factorySubstrates (root);
+    root = factoryCircuits (root);
+    while (root != NULL)
+      root = netlist_unchain_definition (root, root);
+    netlist_free_definition (*it);
   }
+  instances.clear ();
+  netlist_destroy (defs);
 }
 
 /* This static function applies the optional missing properties's
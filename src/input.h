@@ -25,6 +25,11 @@
 #ifndef __INPUT_H__
 #define __INPUT_H__
 
+#include <vector>
+
+struct netlist_t;
+struct definition_t;
+
 namespace qucs {
 
 class net;
@@ -41,7 +46,12 @@ class input : public object
   int netlist (net *);
   FILE * getFile (void) { return fd; }
   void setFile (FILE * f) { fd = f; }
+  void setBuffer (const char *, int);
   void factory (void);
+  void deferSubcircuits (void);
+  void factorySubcircuits (void);
+  struct definition_t * factorySubstrates (struct definition_t *);
+  struct definition_t * factoryCircuits (struct definition_t *);
   circuit * createCircuit (char *);
   analysis * createAnalysis (char *);
   substrate * createSubstrate (char *);
@@ -52,8 +62,12 @@ class input : public object
 
  private:
   FILE * fd;
+  const char * buffer;
+  int length;
+  struct netlist_t * defs;
   net * subnet;
   environment * env;
+  std::vector<struct definition_t *> instances;
 };
 
 // externalize global variable
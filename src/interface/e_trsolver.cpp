@@ -186,6 +186,8 @@ int e_trsolver::init (nr_double_t start, nr_double_t firstdelta, int mode)
     const char * const solver = getPropertyString ("Solver");
     relaxTSR = !strcmp (getPropertyString ("relaxTSR"), "yes") ? true : false;
     initialDC = !strcmp (getPropertyString ("initialDC"), "yes") ? true : false;
+    bypass = !strcmp (getPropertyString ("Bypass"), "yes") ? 1 : 0;
+    threads = getPropertyInteger ("Threads");
     // fetch simulation properties
     MaxIterations = getPropertyInteger ("MaxIter");
     reltol = getPropertyDouble ("reltol");
@@ -199,6 +201,7 @@ int e_trsolver::init (nr_double_t start, nr_double_t firstdelta, int mode)
     fixpoint = 0;
     lastsynctime = 0.0;
     statRejected = statSteps = statIterations = statConvergence = 0;
+    statBypassed = statEvaluated = 0;
 
     // Choose a solver.
     if (!strcmp (solver, "CroutLU"))
@@ -211,6 +214,8 @@ int e_trsolver::init (nr_double_t start, nr_double_t firstdelta, int mode)
         eqnAlgo = ALGO_QR_DECOMPOSITION_LS;
     else if (!strcmp (solver, "GolubSVD"))
         eqnAlgo = ALGO_SV_DECOMPOSITION;
+    else if (!strcmp (solver, "SparseLU"))
+        eqnAlgo = ALGO_LU_DECOMPOSITION_SPARSE;
 
     // Perform initial DC analysis.
     if (initialDC)
@@ -492,7 +497,7 @@ int e_trsolver::stepsolve_sync(nr_double_t synctime)
     if (error) return -1;
 
     // check whether Jacobian matrix is still non-singular
-    if (!A->isFinite ())
+    if (As != NULL ? !As->isFinite () : !A->isFinite ())
     {
 //        messagefcn (LOG_ERROR, "ERROR: %s: Jacobian singular at t = %.3e, "
 //                  "aborting %s analysis\n", getName (), (double) current,
@@ -728,7 +733,7 @@ int e_trsolver::stepsolve_async(nr_double_t steptime)
         if (rejected) continue;
 
         // check whether Jacobian matrix is still non-singular
-        if (!A->isFinite ())
+        if (As != NULL ? !As->isFinite () : !A->isFinite ())
         {
             messagefcn (LOG_ERROR, "ERROR: %s: Jacobian singular at t = %.3e, "
                       "aborting %s analysis\n", getName (), (double) current,
@@ -1060,17 +1065,17 @@ void e_trsolver::truncateHistory (nr_double_t t)
 
 int e_trsolver::getJacRows()
 {
-    return A->getRows();
+    return As != NULL ? As->getRows() : A->getRows();
 }
 
 int e_trsolver::getJacCols()
 {
-    return A->getCols();
+    return As != NULL ? As->getCols() : A->getCols();
 }
 
 void e_trsolver::getJacData(int r, int c, nr_double_t& data)
 {
-    data = A->get(r,c);
+    data = As != NULL ? As->get(r,c) : A->get(r,c);
 }
 
 // properties
@@ -1099,6 +1104,8 @@ PROP_OPT [] =
     { "Solver", PROP_STR, { PROP_NO_VAL, "CroutLU" }, PROP_RNG_SOL },
     { "relaxTSR", PROP_STR, { PROP_NO_VAL, "no" }, PROP_RNG_YESNO },
     { "initialDC", PROP_STR, { PROP_NO_VAL, "yes" }, PROP_RNG_YESNO },
+    { "Bypass", PROP_STR, { PROP_NO_VAL, "no" }, PROP_RNG_YESNO },
+    { "Threads", PROP_INT, { 1, PROP_NO_STR }, PROP_MIN_VAL (1) },
     PROP_NO_PROP
 };
 struct define_t e_trsolver::anadef =
@@ -63,6 +63,10 @@ qucsint::qucsint ()
     //int listing = 0;
     ret = 0;
     err = 0;
+    subnet = NULL;
+    in = NULL;
+    out = NULL;
+    root = NULL;
 
     loginit ();
     ::srand (::time (NULL));
@@ -74,6 +78,10 @@ qucsint::qucsint (char* infile)
     //int listing = 0;
     ret = 0;
     err = 0;
+    subnet = NULL;
+    in = NULL;
+    out = NULL;
+    root = NULL;
 
     loginit ();
     ::srand (::time (NULL));
@@ -85,14 +93,12 @@ qucsint::qucsint (char* infile)
 qucsint::~qucsint ()
 {
     delete subnet;
-    delete in;
 //    delete out;
     delete root;
+    delete in;
 
     // delete modules
     module::unregisterModules ();
-
-    netlist_destroy_env ();
 }
 
 /*!\ todo: replace "root" by / as environment root */
@@ -144,6 +150,9 @@ int qucsint::prepare_netlist (char * infile)
     gnd->setName ("GND");
     subnet->insertCircuit (gnd);
 
+    // the external solvers access the circuits directly
+    subnet->instantiate ();
+
     // apply some data to all analyses
     subnet->setActionNetAll(subnet);
 
@@ -161,6 +170,27 @@ int qucsint::evaluate ()
     return ret;
 }
 
+int qucsint::setProperty (char * name, double value)
+{
+    if (subnet == NULL) return -1;
+    return subnet->setProperty (name, (nr_double_t) value);
+}
+
+int qucsint::evaluate (char * analysis)
+{
+    if (subnet == NULL) return -1;
+
+    // re-run the given analysis only
+    err = 0;
+    ret = 0;
+    delete out;
+    out = subnet->runAnalysis (analysis, err);
+    ret |= err;
+    if (out == NULL) ret |= -1;
+
+    return ret;
+}
+
 int qucsint::output (char * outfile)
 {
     // evaluate output dataset
@@ -73,6 +73,32 @@ public:
     int evaluate ();
     int output (char* outfile);
 
+    /** \brief Sets a property of a circuit in the prepared netlist
+      * \param name Name of the property, e.g. \a R1.R
+      * \param value New value of the property
+      * \return Integer flag reporting success or failure
+      *
+      * The name is made up of the circuit instance name and the
+      * property name separated by a dot.  The new value is used by
+      * the next call of evaluate().  Returns 0 if the property was
+      * found and -1 otherwise.
+      */
+    int setProperty (char * name, double value);
+
+    /** \brief Re-runs a single analysis of the prepared netlist
+      * \param analysis Instance name of the analysis, e.g. \a DC1
+      * \return Integer flag reporting success or failure
+      *
+      * Runs the given analysis again without re-parsing and
+      * re-checking the netlist, e.g. after modifying some properties
+      * using setProperty().  The solvers start from the solution of
+      * their previous run.  The results replace the output dataset.
+      */
+    int evaluate (char * analysis);
+
+    /// Returns the output dataset of the last evaluation.
+    qucs::dataset * getDataset (void) { return out; }
+
 protected:
 
     qucs::net * subnet;
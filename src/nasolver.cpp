@@ -36,6 +36,7 @@
 #include <float.h>
 #include <assert.h>
 #include <limits>
+#include <algorithm>
 
 #include "logging.h"
 #include "complex.h"
@@ -51,11 +52,13 @@
 #include "strlist.h"
 #include "tvector.h"
 #include "tmatrix.h"
+#include "spmatrix.h"
 #include "eqnsys.h"
 #include "precision.h"
 #include "operatingpoint.h"
 #include "exception.h"
 #include "exceptionstack.h"
+#include "threadpool.h"
 #include "nasolver.h"
 #include "constants.h"
 
@@ -67,13 +70,26 @@ nasolver<nr_type_t>::nasolver () : analysis ()
 {
     nlist = NULL;
     A = C = NULL;
+    As = NULL;
     z = x = xprev = zprev = NULL;
     reltol = abstol = vntol = 0;
     calculate_func = NULL;
     convHelper = fixpoint = 0;
     eqnAlgo = ALGO_LU_DECOMPOSITION;
     updateMatrix = 1;
+    linearStamps = linearValid = 0;
+    Af = NULL;
+    chord = chordValid = 0;
+    chordPrev = 0;
+    statFactored = statReused = 0;
     gMin = srcFactor = 0;
+    contValue[0] = contValue[1] = 0;
+    contPoints = 0;
+    bypass = 0;
+    statBypassed = statEvaluated = 0;
+    statIterations = 0;
+    threads = 1;
+    pool = NULL;
     eqns = new eqnsys<nr_type_t> ();
 }
 
@@ -83,13 +99,26 @@ nasolver<nr_type_t>::nasolver (const std::string &n) : analysis (n)
 {
     nlist = NULL;
     A = C = NULL;
+    As = NULL;
     z = x = xprev = zprev = NULL;
     reltol = abstol = vntol = 0;
     calculate_func = NULL;
     convHelper = fixpoint = 0;
     eqnAlgo = ALGO_LU_DECOMPOSITION;
     updateMatrix = 1;
+    linearStamps = linearValid = 0;
+    Af = NULL;
+    chord = chordValid = 0;
+    chordPrev = 0;
+    statFactored = statReused = 0;
     gMin = srcFactor = 0;
+    contValue[0] = contValue[1] = 0;
+    contPoints = 0;
+    bypass = 0;
+    statBypassed = statEvaluated = 0;
+    statIterations = 0;
+    threads = 1;
+    pool = NULL;
     eqns = new eqnsys<nr_type_t> ();
 }
 
@@ -100,11 +129,14 @@ nasolver<nr_type_t>::~nasolver ()
     delete nlist;
     delete C;
     delete A;
+    delete Af;
+    delete As;
     delete z;
     delete x;
     delete xprev;
     delete zprev;
     delete eqns;
+    deleteCircuitList ();
 }
 
 /* The copy constructor creates a new instance of the nasolver class
@@ -115,6 +147,7 @@ nasolver<nr_type_t>::nasolver (nasolver & o) : analysis (o)
     nlist = o.nlist ? new nodelist (*(o.nlist)) : NULL;
     A = o.A ? new tmatrix<nr_type_t> (*(o.A)) : NULL;
     C = o.C ? new tmatrix<nr_type_t> (*(o.C)) : NULL;
+    As = o.As ? new spmatrix<nr_type_t> (*(o.As)) : NULL;
     z = o.z ? new tvector<nr_type_t> (*(o.z)) : NULL;
     x = o.x ? new tvector<nr_type_t> (*(o.x)) : NULL;
     xprev = zprev = NULL;
@@ -126,11 +159,26 @@ nasolver<nr_type_t>::nasolver (nasolver & o) : analysis (o)
     convHelper = o.convHelper;
     eqnAlgo = o.eqnAlgo;
     updateMatrix = o.updateMatrix;
+    linearStamps = linearValid = 0;
+    Af = NULL;
+    chord = o.chord;
+    chordValid = 0;
+    chordPrev = 0;
+    statFactored = statReused = 0;
     fixpoint = o.fixpoint;
     gMin = o.gMin;
     srcFactor = o.srcFactor;
     eqns = new eqnsys<nr_type_t> (*(o.eqns));
     solution = nasolution<nr_type_t> (o.solution);
+    solutionPrev = nasolution<nr_type_t> (o.solutionPrev);
+    contValue[0] = o.contValue[0];
+    contValue[1] = o.contValue[1];
+    contPoints = o.contPoints;
+    bypass = o.bypass;
+    statBypassed = statEvaluated = 0;
+    statIterations = 0;
+    threads = o.threads;
+    pool = NULL;
 }
 
 /* The function runs the nodal analysis solver once, reports errors if
@@ -207,6 +255,9 @@ void nasolver<nr_type_t>::solve_post (void)
 {
     delete nlist;
     nlist = NULL;
+    topo.clear ();
+    vsources.clear ();
+    deleteCircuitList ();
 }
 
 /* Run this function before the actual solver. */
@@ -221,6 +272,8 @@ void nasolver<nr_type_t>::solve_pre (void)
     nlist = new nodelist (subnet);
     nlist->assignNodes ();
     assignVoltageSources ();
+    topo.create (nlist);
+    createCircuitList ();
 #if DEBUG && 0
     nlist->print ();
 #endif
@@ -229,7 +282,30 @@ void nasolver<nr_type_t>::solve_pre (void)
     int M = countVoltageSources ();
     int N = countNodes ();
     delete A;
-    A = new tmatrix<nr_type_t> (M + N);
+    A = NULL;
+    delete Af;
+    Af = NULL;
+    delete As;
+    As = NULL;
+    chordValid = 0;
+    if ((eqnAlgo & ALGO_LU_DECOMPOSITION_SPARSE) && N + M >= SPARSE_MIN_SIZE)
+    {
+        // large equation systems use the sparse matrix engine
+        As = new spmatrix<nr_type_t> (M + N);
+        createStampMap ();
+#if DEBUG
+        logprint (LOG_STATUS, "NOTIFY: %s: using sparse %dx%d matrix with %d "
+                  "non-zeros\n", getName (), N + M, N + M, As->getNonZeros ());
+#endif
+    }
+    else
+    {
+        // fallback to the dense matrix for tiny equation systems
+        if (eqnAlgo & ALGO_LU_DECOMPOSITION_SPARSE)
+            eqnAlgo = ALGO_LU_DECOMPOSITION;
+        A = new tmatrix<nr_type_t> (M + N);
+        createStampMap ();
+    }
     delete z;
     z = new tvector<nr_type_t> (N + M);
     delete x;
@@ -272,6 +348,30 @@ void nasolver<nr_type_t>::applyNodeset (bool nokeep)
     restartNR ();
 }
 
+/* This function applies the initial guess of the Newton-Raphson
+   iteration.  When warm starting and a solution of a previous solver
+   run has been stored it is recalled, or extrapolated along the
+   parameter sweep of a continuation.  Otherwise the nodesets are
+   applied. */
+template <class nr_type_t>
+void nasolver<nr_type_t>::applyStartingValues (void)
+{
+    if (!warmStart || solution.empty () || x == NULL || nlist == NULL)
+    {
+        applyNodeset ();
+        return;
+    }
+    for (int i = 0; i < (int) x->size (); i++) x->set (i, 0);
+    if (continuation != NULL)
+        predictSolution (continuation->getSweepValue ());
+    else
+        recallSolution ();
+    if (xprev != NULL) *xprev = *x;
+    saveSolution ();
+    // propagate the solution to the non-linear circuits
+    restartNR ();
+}
+
 /* The following function uses the gMin-stepping algorithm in order to
    solve the given non-linear netlist by continuous iterations. */
 template <class nr_type_t>
@@ -461,13 +561,20 @@ int nasolver<nr_type_t>::solve_nonlinear (void)
     vntol = getPropertyDouble ("vntol");
     updateMatrix = 1;
 
+    // device evaluations of previous runs are invalid now
+    resetBypass ();
+    chordPrev = 0;
+
+    /* The matrix structure does not change between the iterations, so
+       the equation system solver can reuse the previous pivots. */
+    eqns->setRefactor (1);
+
     if (convHelper == CONV_GMinStepping)
     {
         // use the alternative non-linear solver solve_nonlinear_continuation_gMin
         // instead of the basic solver provided by this function
         iterations = 0;
         error = solve_nonlinear_continuation_gMin ();
-        return error;
     }
     else if (convHelper == CONV_SourceStepping)
     {
@@ -475,51 +582,56 @@ int nasolver<nr_type_t>::solve_nonlinear (void)
         // instead of the basic solver provided by this function
         iterations = 0;
         error = solve_nonlinear_continuation_Source ();
-        return error;
     }
-
-    // run solving loop until convergence is reached
-    do
+    else
     {
-        error = solve_once ();
-        if (!error)
+        // run solving loop until convergence is reached
+        do
         {
-            // convergence check
-            convergence = (run > 0) ? checkConvergence () : 0;
-            savePreviousIteration ();
-            run++;
-            // control fixpoint iterations
-            if (fixpoint)
+            error = solve_once ();
+            if (!error)
             {
-                if (convergence && !updateMatrix)
-                {
-                    updateMatrix = 1;
-                    convergence = 0;
-                }
-                else
+                // convergence check
+                convergence = (run > 0) ? checkConvergence () : 0;
+                savePreviousIteration ();
+                run++;
+                // control fixpoint iterations
+                if (fixpoint)
                 {
-                    updateMatrix = 0;
+                    if (convergence && !updateMatrix)
+                    {
+                        updateMatrix = 1;
+                        convergence = 0;
+                    }
+                    else
+                    {
+                        updateMatrix = 0;
+                    }
                 }
             }
+            else
+            {
+                break;
+            }
         }
-        else
+        while (!convergence &&
+                run < MaxIterations * (1 + convHelper ? 1 : 0));
+
+        if (run >= MaxIterations || error)
         {
-            break;
+            // do not reuse the Jacobian of a failed iteration
+            chordValid = 0;
+            e = new qucs::exception (EXCEPTION_NO_CONVERGENCE);
+            e->setText ("no convergence in %s analysis after %d iterations",
+                        desc.c_str(), run);
+            throw_exception (e);
+            error++;
         }
-    }
-    while (!convergence &&
-            run < MaxIterations * (1 + convHelper ? 1 : 0));
-
-    if (run >= MaxIterations || error)
-    {
-        e = new qucs::exception (EXCEPTION_NO_CONVERGENCE);
-        e->setText ("no convergence in %s analysis after %d iterations",
-                    desc.c_str(), run);
-        throw_exception (e);
-        error++;
+        iterations = run;
     }
 
-    iterations = run;
+    // other solves (e.g. linear ones) may have a different structure
+    eqns->setRefactor (0);
     return error;
 }
 
@@ -528,6 +640,7 @@ template <class nr_type_t>
 int nasolver<nr_type_t>::solve_linear (void)
 {
     updateMatrix = 1;
+    linearValid = 0;
     return solve_once ();
 }
 
@@ -547,10 +660,7 @@ void nasolver<nr_type_t>::createMatrix (void)
        Each of these minor matrices is going to be generated here. */
     if (updateMatrix)
     {
-        createGMatrix ();
-        createBMatrix ();
-        createCMatrix ();
-        createDMatrix ();
+        createStampMatrix ();
     }
 
     /* Adjust G matrix if requested. */
@@ -560,7 +670,10 @@ void nasolver<nr_type_t>::createMatrix (void)
         int M = countVoltageSources ();
         for (int n = 0; n < N + M; n++)
         {
-            A->set (n, n, A->get (n, n) + gMin);
+            if (As != NULL)
+                As->add (n, n, gMin);
+            else
+                A->set (n, n, A->get (n, n) + gMin);
         }
     }
 
@@ -591,112 +704,101 @@ nr_type_t nasolver<nr_type_t>::MatValX (nr_complex_t z, nr_double_t *)
     return real (z);
 }
 
-/* The B matrix is an MxN matrix with only 0, 1 and -1 elements.  Each
-   location in the matrix corresponds to a particular voltage source
-   (first dimension) or a node (second dimension).  If the positive
-   terminal of the ith voltage source is connected to node k, then the
-   element (i,k) in the B matrix is a 1.  If the negative terminal of
-   the ith voltage source is connected to node k, then the element
-   (i,k) in the B matrix is a -1.  Otherwise, elements of the B matrix
-   are zero. */
+/* The function builds the stamp map of the MNA matrix, i.e. it
+   relates each element of the circuits' G, B, C and D matrices to its
+   position in the system matrix.  This is done once before running
+   the solver, the matrix assembly then simply scatters the circuit
+   matrices through the map.  For the sparse matrix the structure is
+   created here as well.  Since each pair of circuit ports and each
+   voltage source appears twice in the map, the sparse matrix is
+   structurally symmetric.  The entries of the linear circuits are
+   placed in front of the others, so the assembly can keep them as a
+   base matrix.  The circuit nodes get their matrix index assigned
+   here too. */
 template <class nr_type_t>
-void nasolver<nr_type_t>::createBMatrix (void)
+void nasolver<nr_type_t>::createStampMap (void)
 {
     int N = countNodes ();
     int M = countVoltageSources ();
-    circuit * vs;
+    int r, c, p, q, k, l;
     struct nodelist_t * n;
-    nr_type_t val;
+    nastamp_t s;
 
-    // go through each voltage sources (first dimension)
-    for (int c = 0; c < M; c++)
+    // assign node numbers, ground node gets a zero
+    for (r = -1; r < N; r++)
     {
-        vs = findVoltageSource (c);
-        // go through each node (second dimension)
-        for (int r = 0; r < N; r++)
-        {
-            val = 0.0;
-            n = nlist->getNode (r);
-            for (auto &current : *n)
-            {
-                // is voltage source connected to node ?
-	      if (current->getCircuit () == vs)
-                {
-		  val += MatVal (vs->getB (current->getPort (), c));
-                }
-            }
-            // put value into B matrix
-            A->set (r, c + N, val);
-        }
+        n = nlist->getNode (r);
+        for (auto &currentn : *n)
+            currentn->setNode (r + 1);
     }
-}
 
-/* The C matrix is an NxM matrix with only 0, 1 and -1 elements.  Each
-   location in the matrix corresponds to a particular node (first
-   dimension) or a voltage source (first dimension).  If the positive
-   terminal of the ith voltage source is connected to node k, then the
-   element (k,i) in the C matrix is a 1.  If the negative terminal of
-   the ith voltage source is connected to node k, then the element
-   (k,i) in the C matrix is a -1.  Otherwise, elements of the C matrix
-   are zero. */
-template <class nr_type_t>
-void nasolver<nr_type_t>::createCMatrix (void)
-{
-    int N = countNodes ();
-    int M = countVoltageSources ();
-    circuit * vs;
-    struct nodelist_t * n;
-    nr_type_t val;
-
-    // go through each voltage sources (second dimension)
-    for (int r = 0; r < M; r++)
+    stamps.clear ();
+    circuit * root = subnet->getRoot ();
+    for (circuit * ct = root; ct != NULL; ct = (circuit *) ct->getNext ())
     {
-        vs = findVoltageSource (r);
-        // go through each node (first dimension)
-        for (int c = 0; c < N; c++)
+        s.ct = ct;
+        // the G matrix
+        s.type = STAMP_G;
+        for (p = 0; p < ct->getSize (); p++)
         {
-            val = 0.0;
-            n = nlist->getNode (c);
-            for (auto &current: *n)
+            if ((r = ct->getNode(p)->getNode () - 1) < 0) continue;
+            for (q = 0; q < ct->getSize (); q++)
             {
-                // is voltage source connected to node ?
-	      if (current->getCircuit () == vs)
-                {
-		  val += MatVal (vs->getC (r, current->getPort ()));
-                }
+                if ((c = ct->getNode(q)->getNode () - 1) < 0) continue;
+                s.r = p; s.c = q; s.row = r; s.col = c;
+                stamps.push_back (s);
             }
-            // put value into C matrix
-            A->set (r + N, c, val);
         }
-    }
-}
-
-/* The D matrix is an MxM matrix that is composed entirely of zeros.
-   It can be non-zero if dependent sources are considered. */
-template <class nr_type_t>
-void nasolver<nr_type_t>::createDMatrix (void)
-{
-    int M = countVoltageSources ();
-    int N = countNodes ();
-    circuit * vsr, * vsc;
-    nr_type_t val;
-    for (int r = 0; r < M; r++)
-    {
-        vsr = findVoltageSource (r);
-        for (int c = 0; c < M; c++)
+        // the B, C and D matrices
+        int vs = ct->getVoltageSource ();
+        int nvs = ct->getVoltageSources ();
+        for (k = vs; k < vs + nvs; k++)
         {
-            vsc = findVoltageSource (c);
-            val = 0.0;
-            if (vsr == vsc)
+            for (p = 0; p < ct->getSize (); p++)
+            {
+                if ((r = ct->getNode(p)->getNode () - 1) < 0) continue;
+                s.type = STAMP_B;
+                s.r = p; s.c = k; s.row = r; s.col = k + N;
+                stamps.push_back (s);
+                s.type = STAMP_C;
+                s.r = k; s.c = p; s.row = k + N; s.col = r;
+                stamps.push_back (s);
+            }
+            s.type = STAMP_D;
+            for (l = vs; l < vs + nvs; l++)
             {
-                val = MatVal (vsr->getD (r, c));
+                s.r = k; s.c = l; s.row = k + N; s.col = l + N;
+                stamps.push_back (s);
             }
-            A->set (r + N, c + N, val);
         }
     }
+
+    // linear circuits with constant matrix entries first
+    linearStamps = (int) (std::stable_partition (
+        stamps.begin (), stamps.end (),
+        [] (nastamp_t & st)
+        {
+            return !st.ct->isNonLinear () && !st.ct->isVariableMatrix ();
+        }) - stamps.begin ());
+    linearValid = 0;
+
+    // create the sparse matrix structure, the diagonal is always part of it
+    if (As != NULL)
+    {
+        for (r = 0; r < N + M; r++) As->insert (r, r);
+        for (auto &st : stamps) As->insert (st.row, st.col);
+        As->compress ();
+    }
+
+    // finally compute the matrix slots
+    for (auto &st : stamps)
+        st.slot = As != NULL ? As->find (st.row, st.col) :
+            st.row * (N + M) + st.col;
 }
 
-/* The G matrix is an NxN matrix formed in two steps.
+/* The A matrix of the MNA consists of four minor matrices.
+
+   The G matrix is an NxN matrix formed in two steps.
    1. Each element in the diagonal matrix is equal to the sum of the
    conductance of each element connected to the corresponding node.
    2. The off diagonal elements are the negative conductance of the
@@ -704,37 +806,82 @@ void nasolver<nr_type_t>::createDMatrix (void)
    resistor between nodes 1 and 2 goes into the G matrix at location
    (1,2) and location (2,1).  If an element is grounded, it will only
    have contribute to one entry in the G matrix -- at the appropriate
-   location on the diagonal. */
+   location on the diagonal.
+
+   The B matrix is an NxM matrix with only 0, 1 and -1 elements.  Each
+   location in the matrix corresponds to a particular node (first
+   dimension) or a voltage source (second dimension).  If the positive
+   terminal of the ith voltage source is connected to node k, then the
+   element (k,i) in the B matrix is a 1.  If the negative terminal of
+   the ith voltage source is connected to node k, then the element
+   (k,i) in the B matrix is a -1.  Otherwise, elements of the B matrix
+   are zero.  The C matrix is the MxN counterpart of the B matrix.
+
+   The D matrix is an MxM matrix that is composed entirely of zeros.
+   It can be non-zero if dependent sources are considered.
+
+   The function adds the circuits' matrix elements using the
+   previously created stamp map, thus the effort is linear in the
+   number of circuit ports.  The elements of the linear circuits with
+   constant matrix entries are kept as a base matrix until the solver
+   invalidates it, e.g. when circuit properties or the integration
+   coefficients change.  Only the remaining circuits are stamped on top
+   of it in each iteration. */
 template <class nr_type_t>
-void nasolver<nr_type_t>::createGMatrix (void)
+void nasolver<nr_type_t>::createStampMatrix (void)
 {
-    int pr, pc, N = countNodes ();
-    nr_type_t g;
-    struct nodelist_t * nr, * nc;
-    circuit * ct;
+    nr_type_t * data;
+    int size;
+    if (As != NULL)
+    {
+        data = As->getData ();
+        size = As->getNonZeros ();
+    }
+    else
+    {
+        data = A->getData ();
+        size = A->getRows () * A->getCols ();
+    }
 
-    // go through each column of the G matrix
-    for (int c = 0; c < N; c++)
+    if (!linearValid)
     {
-        nc = nlist->getNode (c);
-        // go through each row of the G matrix
-        for (int r = 0; r < N; r++)
+        // stamp the linear circuits and save the base matrix
+        std::fill (data, data + size, (nr_type_t) 0.0);
+        addStamps (data, 0, linearStamps);
+        linearBase.assign (data, data + size);
+        linearValid = 1;
+    }
+    else
+    {
+        std::copy (linearBase.begin (), linearBase.end (), data);
+    }
+    addStamps (data, linearStamps, (int) stamps.size ());
+}
+
+// Adds the given range of stamp map entries to the matrix data.
+template <class nr_type_t>
+void nasolver<nr_type_t>::addStamps (nr_type_t * data, int from, int to)
+{
+    for (int i = from; i < to; i++)
+    {
+        nastamp_t & s = stamps[i];
+        nr_complex_t val;
+        switch (s.type)
         {
-            nr = nlist->getNode (r);
-            g = 0.0;
-            // sum up the conductance of each connected circuit
-            for (auto & currentnc  : *nc)
-	      for (auto & currentnr: *nr)
-		if (currentnc->getCircuit () == currentnr->getCircuit ())
-		  {
-		    ct = currentnc->getCircuit ();
-		    pc = currentnc->getPort ();
-		    pr = currentnr->getPort ();
-		    g += MatVal (ct->getY (pr, pc));
-		  }
-            // put value into G matrix
-            A->set (r, c, g);
+        case STAMP_G:
+            val = s.ct->getY (s.r, s.c);
+            break;
+        case STAMP_B:
+            val = s.ct->getB (s.r, s.c);
+            break;
+        case STAMP_C:
+            val = s.ct->getC (s.r, s.c);
+            break;
+        default:
+            val = s.ct->getD (s.r, s.c);
+            break;
         }
+        data[s.slot] += MatVal (val);
     }
 }
 
@@ -745,10 +892,8 @@ void nasolver<nr_type_t>::createNoiseMatrix (void)
 {
     int pr, pc, N = countNodes ();
     int M = countVoltageSources ();
-    struct nodelist_t * n;
     nr_type_t val;
-    int r, c, ri, ci;
-    struct nodelist_t * nr, * nc;
+    int r, c, ri, ci, t, i;
     circuit * ct;
 
     // create new Cy matrix if necessary
@@ -758,26 +903,18 @@ void nasolver<nr_type_t>::createNoiseMatrix (void)
     // go through each column of the Cy matrix
     for (c = 0; c < N; c++)
     {
-        nc = nlist->getNode (c);
-        // go through each row of the Cy matrix
-        for (r = 0; r < N; r++)
+        // sum up the noise-correlation of each circuit connected to the
+        // column node into the rows of the nodes of its other ports
+        for (t = topo.getFirstTerminal (c); t < topo.getLastTerminal (c); t++)
         {
-            nr = nlist->getNode (r);
-            val = 0.0;
-            // sum up the noise-correlation of each connected circuit
-            for (auto & currentnc: *nc)
-		/* a = 0; a < nc->size(); a++ */
-	      for (auto &currentnr : *nr)
-		/* b = 0; b < nr->size(); b++) */
-                    if (currentnc->getCircuit () == currentnr->getCircuit ())
-                    {
-                        ct = currentnc->getCircuit ();
-                        pc = currentnc->getPort ();
-                        pr = currentnr->getPort ();
-                        val += MatVal (ct->getN (pr, pc));
-                    }
-            // put value into Cy matrix
-            C->set (r, c, val);
+            i = topo.getTerminalIndex (t);
+            ct = topo.getCircuit (i);
+            pc = topo.getTerminalPort (t);
+            for (pr = 0; pr < topo.getPorts (i); pr++)
+            {
+                if ((r = topo.getNode (i, pr)) < 0) continue;
+                (*C) (r, c) += MatVal (ct->getN (pr, pc));
+            }
         }
     }
 
@@ -801,52 +938,31 @@ void nasolver<nr_type_t>::createNoiseMatrix (void)
         }
     }
 
-    // go through each additional voltage source
+    // go through each additional voltage source and each of its ports
     for (r = 0; r < M; r++)
     {
         vsr = findVoltageSource (r);
-        // go through each node
-        for (c = 0; c < N; c++)
+        i = topo.getIndex (vsr);
+        ri = vsr->getSize () + r - vsr->getVoltageSource ();
+        for (pc = 0; pc < topo.getPorts (i); pc++)
         {
-            val = 0.0;
-            n = nlist->getNode (c);
-            for (auto &currentn: *n)
-	      /*i = 0; i < n->size(); i++ )*/
-            {
-                // is voltage source connected to node ?
-                if (currentn->getCircuit () == vsr)
-                {
-                    ri = vsr->getSize () + r - vsr->getVoltageSource ();
-                    ci = currentn->getPort ();
-                    val += MatVal (vsr->getN (ri, ci));
-                }
-            }
-            // put value into Cy matrix
-            C->set (r + N, c, val);
+            // is the port connected to a node ?
+            if ((c = topo.getNode (i, pc)) < 0) continue;
+            (*C) (r + N, c) += MatVal (vsr->getN (ri, pc));
         }
     }
 
-    // go through each voltage source
+    // go through each voltage source and each of its ports
     for (c = 0; c < M; c++)
     {
         vsc = findVoltageSource (c);
-        // go through each node
-        for (r = 0; r < N; r++)
+        i = topo.getIndex (vsc);
+        ci = vsc->getSize () + c - vsc->getVoltageSource ();
+        for (pr = 0; pr < topo.getPorts (i); pr++)
         {
-            val = 0.0;
-            n = nlist->getNode (r);
-            for (auto & currentn: *n)/*i = 0; i < n->size(); i++)*/
-            {
-                // is voltage source connected to node ?
-                if (currentn->getCircuit () == vsc)
-                {
-                    ci = vsc->getSize () + c - vsc->getVoltageSource ();
-                    ri = currentn->getPort ();
-                    val += MatVal (vsc->getN (ri, ci));
-                }
-            }
-            // put value into Cy matrix
-            C->set (r, c + N, val);
+            // is the port connected to a node ?
+            if ((r = topo.getNode (i, pr)) < 0) continue;
+            (*C) (r, c + N) += MatVal (vsc->getN (pr, ci));
         }
     }
 
@@ -862,22 +978,21 @@ void nasolver<nr_type_t>::createIVector (void)
 {
     int N = countNodes ();
     nr_type_t val;
-    struct nodelist_t * n;
     circuit * is;
 
     // go through each node
     for (int r = 0; r < N; r++)
     {
         val = 0.0;
-        n = nlist->getNode (r);
         // go through each circuit connected to the node
-        for (auto &currentn: *n)/* int i = 0; i < n->size(); i++)*/
+        for (int t = topo.getFirstTerminal (r); t < topo.getLastTerminal (r);
+             t++)
         {
-	  is = currentn->getCircuit ();
-	  // is this a current source ?
-	  if (is->isISource () || is->isNonLinear ())
-	    {
-	      val += MatVal (is->getI (currentn->getPort ()));
+            is = topo.getTerminalCircuit (t);
+            // is this a current source ?
+            if (is->isISource () || is->isNonLinear ())
+            {
+                val += MatVal (is->getI (topo.getTerminalPort (t)));
             }
         }
         // put value into i vector
@@ -932,17 +1047,8 @@ int nasolver<nr_type_t>::getNodeNr (const std::string &str)
 template <class nr_type_t>
 int nasolver<nr_type_t>::findAssignedNode (circuit * c, int port)
 {
-    int N = countNodes ();
-    struct nodelist_t * n;
-    for (int r = 0; r < N; r++)
-    {
-        n = nlist->getNode (r);
-        for (auto &currentn : *n) /*int i = 0; i < n->size(); i++)*/
-            if (c == currentn->getCircuit ())
-                if (port == currentn->getPort ())
-                    return r;
-    }
-    return -1;
+    int i = topo.getIndex (c);
+    return i < 0 ? -1 : topo.getNode (i, port);
 }
 
 // Returns the number of voltage sources in the nodelist.
@@ -953,35 +1059,33 @@ int nasolver<nr_type_t>::countVoltageSources (void)
 }
 
 /* The function returns the voltage source circuit object
-   corresponding to the given number.  If there is no such voltage
-   source it returns NULL. */
+   corresponding to the given number using the table created by
+   assignVoltageSources().  If there is no such voltage source it
+   returns NULL. */
 template <class nr_type_t>
 circuit * nasolver<nr_type_t>::findVoltageSource (int n)
 {
-    circuit * root = subnet->getRoot ();
-    for (circuit * c = root; c != NULL; c = (circuit *) c->getNext ())
-    {
-        if (n >= c->getVoltageSource () &&
-                n <= c->getVoltageSource () + c->getVoltageSources () - 1)
-            return c;
-    }
+    if (n >= 0 && n < (int) vsources.size ())
+        return vsources[n];
     return NULL;
 }
 
 /* The function applies unique voltage source identifiers to each
    voltage source (explicit and built in internal ones) in the list of
-   registered circuits. */
+   registered circuits and records the owning circuit of each one. */
 template <class nr_type_t>
 void nasolver<nr_type_t>::assignVoltageSources (void)
 {
     circuit * root = subnet->getRoot ();
     int nSources = 0;
+    vsources.clear ();
     for (circuit * c = root; c != NULL; c = (circuit *) c->getNext ())
     {
         if (c->getVoltageSources () > 0)
         {
             c->setVoltageSource (nSources);
             nSources += c->getVoltageSources ();
+            vsources.resize (nSources, c);
         }
     }
     subnet->setVoltageSources (nSources);
@@ -993,10 +1097,23 @@ template <class nr_type_t>
 void nasolver<nr_type_t>::runMNA (void)
 {
 
-    // just solve the equation system here
-    eqns->setAlgo (eqnAlgo);
-    eqns->passEquationSys (updateMatrix ? A : NULL, x, z);
-    eqns->solve ();
+    // modified Newton-Raphson if requested
+    if (chord && updateMatrix && !fixpoint && !convHelper &&
+            (eqnAlgo == ALGO_LU_DECOMPOSITION ||
+             eqnAlgo == ALGO_LU_DECOMPOSITION_SPARSE))
+    {
+        runChord ();
+    }
+    else
+    {
+        // just solve the equation system here
+        eqns->setAlgo (eqnAlgo);
+        if (As != NULL)
+            eqns->passEquationSys (updateMatrix ? As : NULL, x, z);
+        else
+            eqns->passEquationSys (updateMatrix ? A : NULL, x, z);
+        eqns->solve ();
+    }
 
     // if damped Newton-Raphson is requested
     if (xprev != NULL && top_exception () == NULL)
@@ -1016,6 +1133,108 @@ void nasolver<nr_type_t>::runMNA (void)
     }
 }
 
+/* The function performs a modified Newton-Raphson (chord) step.  The
+   update of the solution vector is computed from the residual of the
+   current Jacobian and right hand side vector.  The LU factors of a
+   previous Jacobian are reused by forward and backward substitutions
+   until the update does not shrink fast enough anymore, then the
+   current Jacobian is factorized in the next iteration.  The dense
+   matrix is factorized in a copy, since the residual needs the
+   Jacobian itself. */
+template <class nr_type_t>
+void nasolver<nr_type_t>::runChord (void)
+{
+    int r, c, n = x->size ();
+    tvector<nr_type_t> res = *z;
+    tvector<nr_type_t> dx (n);
+
+    // compute the residual z - A * x
+    if (As != NULL)
+    {
+        const int * Ap = As->getColPtr ();
+        const int * Ai = As->getRowIdx ();
+        const nr_type_t * Ax = As->getData ();
+        for (c = 0; c < n; c++)
+        {
+            nr_type_t xc = x->get (c);
+            for (int p = Ap[c]; p < Ap[c + 1]; p++)
+                res (Ai[p]) -= Ax[p] * xc;
+        }
+    }
+    else
+    {
+        for (r = 0; r < n; r++)
+        {
+            nr_type_t f = res (r);
+            for (c = 0; c < n; c++)
+                f -= (*A) (r, c) * x->get (c);
+            res (r) = f;
+        }
+    }
+
+    int reused = chordValid;
+    if (reused)
+    {
+        // substitute using the previous factors
+        if (As != NULL)
+        {
+            eqns->setAlgo (ALGO_LU_SUBSTITUTION_SPARSE);
+            eqns->passEquationSys ((spmatrix<nr_type_t> *) NULL, &dx, &res);
+        }
+        else
+        {
+            eqns->setAlgo (ALGO_LU_SUBSTITUTION_CROUT);
+            eqns->passEquationSys ((tmatrix<nr_type_t> *) NULL, &dx, &res);
+        }
+    }
+    else
+    {
+        // factorize the current Jacobian
+        eqns->setAlgo (eqnAlgo);
+        if (As != NULL)
+        {
+            eqns->passEquationSys (As, &dx, &res);
+        }
+        else
+        {
+            if (Af == NULL)
+                Af = new tmatrix<nr_type_t> (*A);
+            else
+                *Af = *A;
+            eqns->passEquationSys (Af, &dx, &res);
+        }
+        statFactored++;
+        chordValid = 1;
+    }
+    eqns->solve ();
+    if (top_exception () != NULL)
+    {
+        chordValid = 0;
+        return;
+    }
+
+    // check the rate of convergence
+    nr_double_t dMax = 0;
+    for (r = 0; r < n; r++)
+        dMax = std::max (dMax, (nr_double_t) abs (dx (r)));
+    if (reused && chordPrev > 0 && dMax > CHORD_RATE * chordPrev)
+    {
+        chordValid = 0;
+        // discard a diverging update and factorize right away
+        if (dMax > chordPrev)
+        {
+            runChord ();
+            return;
+        }
+    }
+    chordPrev = dMax;
+
+    // apply the update, counting it if the previous factors were reused
+    for (r = 0; r < n; r++)
+        x->set (r, x->get (r) + dx (r));
+    if (reused) statReused++;
+}
+
 /* This function applies a damped Newton-Raphson (limiting scheme) to
    the current solution vector in the form x1 = x0 + a * (x1 - x0).  This
    convergence helper is heuristic and does not ensure global convergence. */
@@ -1209,28 +1428,142 @@ void nasolver<nr_type_t>::restartNR (void)
     }
 }
 
+/* The function decides whether the evaluation of the given circuit
+   can be bypassed during the current iteration.  This applies to
+   non-linear devices whose terminal voltages did not change
+   significantly since their last evaluation.  The outcome is counted
+   in the given statistics, i.e. the bypassed and evaluated devices. */
+template <class nr_type_t>
+bool nasolver<nr_type_t>::bypassCircuit (circuit * c, int * stat)
+{
+    if (!c->isNonLinear () || !c->canBypass ()) return false;
+    if (bypass && c->checkBypass (reltol, abstol, vntol))
+    {
+        stat[0]++;
+        return true;
+    }
+    stat[1]++;
+    return false;
+}
+
+/* The function sorts the circuits of the netlist into flat arrays of
+   serially and concurrently evaluated ones.  If more than one thread
+   is requested and there are enough concurrent devices, these are
+   split into contiguous chunks and a thread pool is started. */
+template <class nr_type_t>
+void nasolver<nr_type_t>::createCircuitList (void)
+{
+    deleteCircuitList ();
+    circuit * root = subnet->getRoot ();
+    for (circuit * c = root; c != NULL; c = (circuit *) c->getNext ())
+    {
+        if (c->isConcurrent ())
+            devices.push_back (c);
+        else
+            circuits.push_back (c);
+    }
+
+    int n = (int) devices.size ();
+    if (threads <= 1 || n < threads * THREAD_MIN_DEVICES) return;
+
+    // a few chunks per thread even out differently expensive devices
+    int k = std::min (threads * 4, n / THREAD_MIN_DEVICES);
+    for (int i = 0; i <= k; i++) chunks.push_back ((int) ((long) n * i / k));
+    pool = new threadpool (threads);
+#if DEBUG
+    logprint (LOG_STATUS, "NOTIFY: %s: evaluating %d devices in %d chunks "
+              "using %d threads\n", getName (), n, k, threads);
+#endif
+}
+
+// Deletes the circuit lists and the thread pool.
+template <class nr_type_t>
+void nasolver<nr_type_t>::deleteCircuitList (void)
+{
+    circuits.clear ();
+    devices.clear ();
+    chunks.clear ();
+    delete pool;
+    pool = NULL;
+}
+
+/* The function runs the given evaluation function for each circuit in
+   the netlist unless its evaluation can be bypassed.  The circuits
+   which cannot be evaluated concurrently go first and in the order of
+   the netlist.  Then the devices are evaluated, by the thread pool if
+   available.  Since each device only writes its own MNA entries, the
+   subsequent assembly of the equation system gives the same results
+   independent of the number of threads. */
+template <class nr_type_t>
+void nasolver<nr_type_t>::evaluate (evaluate_func_t f)
+{
+    int stat[2] = { 0, 0 };
+    int i, n = (int) circuits.size ();
+    for (i = 0; i < n; i++)
+    {
+        if (!bypassCircuit (circuits[i], stat)) (*f) (circuits[i], this);
+    }
+
+    if (pool != NULL)
+    {
+        int k = (int) chunks.size () - 1;
+        std::vector<int> cstat (2 * k, 0);
+        pool->run (k, [&] (int c)
+        {
+            int * s = &cstat[2 * c];
+            for (int j = chunks[c]; j < chunks[c + 1]; j++)
+            {
+                if (!bypassCircuit (devices[j], s)) (*f) (devices[j], this);
+            }
+        });
+        for (i = 0; i < k; i++)
+        {
+            stat[0] += cstat[2 * i];
+            stat[1] += cstat[2 * i + 1];
+        }
+    }
+    else
+    {
+        n = (int) devices.size ();
+        for (i = 0; i < n; i++)
+        {
+            if (!bypassCircuit (devices[i], stat)) (*f) (devices[i], this);
+        }
+    }
+    statBypassed += stat[0];
+    statEvaluated += stat[1];
+}
+
+/* This function invalidates the terminal voltages remembered by the
+   non-linear circuits, i.e. each of them is evaluated during the next
+   iteration. */
+template <class nr_type_t>
+void nasolver<nr_type_t>::resetBypass (void)
+{
+    circuit * root = subnet->getRoot ();
+    for (circuit * c = root; c != NULL; c = (circuit *) c->getNext ())
+    {
+        if (c->isNonLinear ()) c->clearBypass ();
+    }
+}
+
 /* This function goes through solution (the x vector) and saves the
    node voltages of the last iteration into each non-linear
    circuit. */
 template <class nr_type_t>
 void nasolver<nr_type_t>::saveNodeVoltages (void)
 {
-    int N = countNodes ();
-    struct nodelist_t * n;
+    int t, N = countNodes ();
     // save all nodes except reference node
     for (int r = 0; r < N; r++)
     {
-        n = nlist->getNode (r);
-        /* for (int i = 0; i < n->size(); i++)*/
-	for(auto &currentn: *n)
-        {
-	  currentn->getCircuit()->setV (currentn->getPort (), x->get (r));
-        }
+        for (t = topo.getFirstTerminal (r); t < topo.getLastTerminal (r); t++)
+            topo.getTerminalCircuit (t)->setV (topo.getTerminalPort (t),
+                                               x->get (r));
     }
     // save reference node
-    n = nlist->getNode (-1);
-    for(auto &currentn: *n)
-      currentn->getCircuit()->setV (currentn->getPort (), 0.0);
+    for (t = topo.getFirstTerminal (-1); t < topo.getLastTerminal (-1); t++)
+        topo.getTerminalCircuit (t)->setV (topo.getTerminalPort (t), 0.0);
 }
 
 /* This function goes through solution (the x vector) and saves the
@@ -1314,6 +1647,62 @@ void nasolver<nr_type_t>::recallSolution (void)
     }
 }
 
+/* The function stores the solution of a continuation for the given
+   value of the swept parameter and keeps the previous one. */
+template <class nr_type_t>
+void nasolver<nr_type_t>::storeContinuation (nr_double_t p)
+{
+    solutionPrev.swap (solution);
+    storeSolution ();
+    contValue[0] = contValue[1];
+    contValue[1] = p;
+    contPoints++;
+}
+
+/* This function recalls the solution of a continuation linearly
+   extrapolated from the last two stored solutions to the given value
+   of the swept parameter. */
+template <class nr_type_t>
+void nasolver<nr_type_t>::predictSolution (nr_double_t p)
+{
+    recallSolution ();
+    if (contPoints < 2 || contValue[1] == contValue[0]) return;
+    nr_double_t f = (p - contValue[1]) / (contValue[1] - contValue[0]);
+    int r;
+    int N = countNodes ();
+    int M = countVoltageSources ();
+    for (r = 0; r < N; r++)
+    {
+        struct nodelist_t * n = nlist->getNode (r);
+	auto na = solution.find (n->name);
+	auto nb = solutionPrev.find (n->name);
+	if (na != solution.end () && nb != solutionPrev.end ())
+	  if ((*na).second.current == 0 && (*nb).second.current == 0)
+	    x->set (r, (*na).second.value +
+		    f * ((*na).second.value - (*nb).second.value));
+    }
+    for (r = 0; r < M; r++)
+    {
+        circuit * vs = findVoltageSource (r);
+        int vn = r - vs->getVoltageSource () + 1;
+	auto na = solution.find (vs->getName ());
+	auto nb = solutionPrev.find (vs->getName ());
+	if (na != solution.end () && nb != solutionPrev.end ())
+	  if ((*na).second.current == vn && (*nb).second.current == vn)
+	    x->set (r + N, (*na).second.value +
+		    f * ((*na).second.value - (*nb).second.value));
+    }
+}
+
+// The function drops the stored solutions of a continuation.
+template <class nr_type_t>
+void nasolver<nr_type_t>::resetContinuation (void)
+{
+    solution.clear ();
+    solutionPrev.clear ();
+    contPoints = 0;
+}
+
 /* This function saves the results of a single solve() functionality
    into the output dataset. */
 template <class nr_type_t>
@@ -31,11 +31,15 @@
 // BUG
 #include "qucs_typedefs.h"
 #endif
+#include <vector>
+
 #include "tvector.h"
 #include "tmatrix.h"
+#include "spmatrix.h"
 #include "eqnsys.h"
 #include "nasolution.h"
 #include "analysis.h"
+#include "topology.h"
 
 // Convergence helper definitions.
 #define CONV_None            0
@@ -45,12 +49,42 @@
 #define CONV_GMinStepping    4
 #define CONV_SourceStepping  5
 
+// Smallest equation system solved using the sparse matrix engine.
+#define SPARSE_MIN_SIZE      32
+
+// Least number of devices per thread evaluated concurrently.
+#define THREAD_MIN_DEVICES   16
+
+// Largest ratio of successive modified Newton updates.
+#define CHORD_RATE           0.5
+
 namespace qucs {
 
 class analysis;
 class circuit;
 class nodelist;
 class vector;
+class threadpool;
+
+// Types of the MNA stamp map entries.
+enum stamp_type
+{
+    STAMP_G = 0,
+    STAMP_B,
+    STAMP_C,
+    STAMP_D
+};
+
+/* An entry of the MNA stamp map relates an element of a circuit's
+   matrices to its position in the system matrix. */
+struct nastamp_t
+{
+    circuit * ct;   // the circuit
+    int type;       // G, B, C or D matrix
+    int r, c;       // indices into the circuit matrix
+    int row, col;   // position in the system matrix
+    int slot;       // index into the matrix data
+};
 
 template <class nr_type_t>
 class nasolver : public analysis
@@ -71,6 +105,7 @@ public:
     std::string getDescription (void) const { return desc; }
     void saveResults (const std::string &, const std::string &, int, qucs::vector * f = NULL);
     typedef void (* calculate_func_t) (nasolver<nr_type_t> *);
+    typedef void (* evaluate_func_t) (circuit *, nasolver<nr_type_t> *);
     void setCalculation (calculate_func_t f) { calculate_func = f; }
     void calculate (void)
     {
@@ -83,6 +118,12 @@ public:
     int getN ();
     /// Returns the number of branch currents in the circuit.
     int getM ();
+    /// Returns the number of Newton iterations of the solver.
+    int getIterations (void) { return statIterations; }
+    /// Returns the number of bypassed device evaluations.
+    int getBypassed (void) { return statBypassed; }
+    /// Returns the number of iterations reusing a factorized Jacobian.
+    int getReused (void) { return statReused; }
 
 protected:
     void restartNR (void);
@@ -95,19 +136,28 @@ protected:
     void saveSolution (void);
     circuit * findVoltageSource (int);
     void applyNodeset (bool nokeep = true);
+    void applyStartingValues (void);
     void createNoiseMatrix (void);
     void runMNA (void);
+    void runChord (void);
     void createMatrix (void);
     void storeSolution (void);
     void recallSolution (void);
+    void storeContinuation (nr_double_t);
+    void predictSolution (nr_double_t);
+    void resetContinuation (void);
     int  checkConvergence (void);
+    bool bypassCircuit (circuit *, int *);
+    void resetBypass (void);
+    void evaluate (evaluate_func_t);
 
 private:
     void assignVoltageSources (void);
-    void createGMatrix (void);
-    void createBMatrix (void);
-    void createCMatrix (void);
-    void createDMatrix (void);
+    void createCircuitList (void);
+    void deleteCircuitList (void);
+    void createStampMap (void);
+    void createStampMatrix (void);
+    void addStamps (nr_type_t *, int, int);
     void createIVector (void);
     void createEVector (void);
     void createZVector (void);
@@ -129,6 +179,8 @@ protected:
     tvector<nr_type_t> * zprev;
     tmatrix<nr_type_t> * A;
     tmatrix<nr_type_t> * C;
+    tmatrix<nr_type_t> * Af;
+    spmatrix<nr_type_t> * As;
     int iterations;
     int convHelper;
     int fixpoint;
@@ -137,13 +189,38 @@ protected:
     nr_double_t gMin, srcFactor;
     std::string desc;
     nodelist * nlist;
+    topology topo;
 
 private:
     eqnsys<nr_type_t> * eqns;
+    std::vector<nastamp_t> stamps;
+    std::vector<nr_type_t> linearBase;
+    int linearStamps;
+    std::vector<circuit *> vsources;
+    std::vector<circuit *> circuits;
+    std::vector<circuit *> devices;
+    std::vector<int> chunks;
+    threadpool * pool;
     nr_double_t reltol;
     nr_double_t abstol;
     nr_double_t vntol;
     nasolution<nr_type_t> solution;
+    nasolution<nr_type_t> solutionPrev;
+    nr_double_t chordPrev;
+
+protected:
+    nr_double_t contValue[2];
+    int contPoints;
+    int bypass;
+    int statBypassed;
+    int statEvaluated;
+    int statIterations;
+    int threads;
+    int linearValid;
+    int chord;
+    int chordValid;
+    int statFactored;
+    int statReused;
 
 private:
 
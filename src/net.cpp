@@ -50,6 +50,7 @@
 #include "equation.h"
 #include "environment.h"
 #include "component_id.h"
+#include "input.h"
 
 namespace qucs {
 
@@ -57,24 +58,26 @@ namespace qucs {
 net::net () : object () {
   root = drop = NULL;
   nPorts = nCircuits = nSources = 0;
-  insertedNodes = inserted = reduced = 0;
+  insertedNodes = inserted = reduced = ordered = 0;
   actions = new ptrlist<analysis> ();
   orgacts = new ptrlist<analysis> ();
   env = NULL;
   nset = NULL;
   srcFactor = 1;
+  deferred = NULL;
 }
 
 // Constructor creates a named instance of the net class.
 net::net (const std::string &n) : object (n) {
   root = drop = NULL;
   nPorts = nCircuits = nSources = 0;
-  insertedNodes = inserted = reduced = 0;
+  insertedNodes = inserted = reduced = ordered = 0;
   actions = new ptrlist<analysis> ();
   orgacts = new ptrlist<analysis> ();
   env = NULL;
   nset = NULL;
   srcFactor = 1;
+  deferred = NULL;
 }
 
 // Destructor deletes the net class object.
@@ -102,12 +105,13 @@ net::~net () {
 net::net (net & n) : object (n) {
   root = drop = NULL;
   nPorts = nCircuits = nSources = 0;
-  insertedNodes = inserted = reduced = 0;
+  insertedNodes = inserted = reduced = ordered = 0;
   actions = n.actions ? new ptrlist<analysis> (*n.actions) : NULL;
   orgacts = new ptrlist<analysis> ();
   env = n.env;
   nset = NULL;
   srcFactor = 1;
+  deferred = NULL;
 }
 
 /* This function prepends the given circuit to the list of registered
@@ -236,6 +240,9 @@ int net::containsAnalysis (analysis * child, int type) {
 dataset * net::runAnalysis (int &err) {
   dataset * out = new dataset ();
 
+  // create the circuits of the subcircuit instances
+  instantiate ();
+
   // apply some data to all analyses
   for (auto *a : *actions) {
     if (!a->isExternal ())
@@ -276,6 +283,103 @@ dataset * net::runAnalysis (int &err) {
   return out;
 }
 
+/* This function runs the given analysis of an already prepared
+   netlist once again, e.g. after some circuit properties have been
+   modified by setProperty().  The netlist is neither re-parsed nor
+   re-checked and the iterative solvers start from the solution of
+   their previous run.  Analyses depending on an operating point are
+   preceded by the DC analysis.  The function returns a new dataset
+   or NULL if there is no such analysis. */
+dataset * net::runAnalysis (const std::string &n, int &err) {
+  analysis * a = NULL, * dc = NULL;
+
+  // find the requested analysis, possibly a child of a sweep
+  for (auto *o : *orgacts) {
+    if (o->getName () == n) a = o;
+    if (o->getType () == ANALYSIS_DC) dc = o;
+  }
+  if (a == NULL || a->isExternal ()) {
+    logprint (LOG_ERROR, "ERROR: no such analysis `%s'\n", n.c_str ());
+    err++;
+    return NULL;
+  }
+  dataset * out = new dataset ();
+  instantiate ();
+
+  // apply some data to all analyses
+  for (auto *o : *orgacts) {
+    if (!o->isExternal ()) {
+      o->setNet (this);
+      o->setData (out);
+      o->setWarmStart (true);
+    }
+  }
+
+  // order analyses once
+  if (!ordered) orderAnalysis ();
+
+  // run the analysis and the DC analysis if necessary
+  ptrlist<analysis> run;
+  run.push_front (a);
+  if (dc != NULL && dc != a && a->getType () != ANALYSIS_DC &&
+      a->getType () != ANALYSIS_SWEEP)
+    run.push_front (dc);
+  for (auto *o : run) err |= o->initialize ();
+  for (auto *o : run) {
+    o->getEnv()->runSolver ();
+    err |= o->solve ();
+  }
+  for (auto *o : run) err |= o->cleanup ();
+
+  // the warm start applies to this run only
+  for (auto *o : *orgacts) {
+    if (!o->isExternal ()) o->setWarmStart (false);
+  }
+  return out;
+}
+
+/* The circuits of subcircuit instances are created by the input
+   object on first use, i.e. when an analysis is run or a circuit is
+   looked up.  The input object must exist until then. */
+void net::instantiate (void) {
+  if (deferred != NULL) {
+    input * in = deferred;
+    deferred = NULL;
+    in->factorySubcircuits ();
+  }
+}
+
+/* The function returns the circuit specified by the given instance
+   name and returns NULL if there is no such circuit. */
+circuit * net::findCircuit (const std::string &n) {
+  instantiate ();
+  for (circuit * c = root; c != NULL; c = (circuit *) c->getNext ()) {
+    if (c->getName () == n)
+      return c;
+  }
+  return NULL;
+}
+
+/* This function sets the value of a circuit property given in the
+   form `instance.property', e.g. `R1.R'.  The new value is used by
+   the next analysis run.  It returns zero on success and non-zero if
+   there is no such circuit or property. */
+int net::setProperty (const std::string &n, nr_double_t val) {
+  std::string::size_type dot = n.rfind ('.');
+  if (dot == std::string::npos) {
+    logprint (LOG_ERROR, "ERROR: invalid property name `%s'\n", n.c_str ());
+    return -1;
+  }
+  std::string key = n.substr (dot + 1);
+  circuit * c = findCircuit (n.substr (0, dot));
+  if (c == NULL || !c->hasProperty (key)) {
+    logprint (LOG_ERROR, "ERROR: no such property `%s'\n", n.c_str ());
+    return -1;
+  }
+  c->setProperty (key, val);
+  return 0;
+}
+
 /* The function returns the analysis with the second lowest order.  If
    there is no recursive sweep it returns NULL. */
 analysis * net::findSecondOrder (void) {
@@ -344,6 +448,7 @@ void net::orderAnalysis (void) {
   sortChildAnalyses (parent);
   actions = new ptrlist<analysis> (*(parent->getAnalysis ()));
   delete parent;
+  ordered = 1;
 }
 
 // This function sorts the analyses of the given parent analysis.
@@ -37,6 +37,7 @@ class nodeset;
 class analysis;
 class dataset;
 class environment;
+class input;
 
 
 class net : public object
@@ -61,6 +62,9 @@ class net : public object
   void insertAnalysis (analysis *);
   void removeAnalysis (analysis *);
   dataset * runAnalysis (int &);
+  dataset * runAnalysis (const std::string &, int &);
+  circuit * findCircuit (const std::string &);
+  int  setProperty (const std::string &, nr_double_t);
   void getDroppedCircuits (nodelist * nodes = NULL);
   void deleteUnusedCircuits (nodelist * nodes = NULL);
   int  getPorts (void) { return nPorts; }
@@ -89,6 +93,8 @@ class net : public object
   void setSrcFactor (nr_double_t f) { srcFactor = f; }
   nr_double_t getSrcFactor (void) { return srcFactor; }
   void setActionNetAll(net *);
+  void setDeferred (input * i) { deferred = i; }
+  void instantiate (void);
 
  private:
   nodeset * nset;
@@ -103,7 +109,9 @@ class net : public object
   int reduced;
   int inserted;
   int insertedNodes;
+  int ordered;
   nr_double_t srcFactor;
+  input * deferred;
 };
 
 } // namespace qucs
@@ -161,8 +161,8 @@ struct define_t {
 #define PROP_RNG_MOS      PROP_RNG_STR2 ("nmos", "pmos")
 #define PROP_RNG_TYP      PROP_RNG_STR4 ("lin", "log", "list", "const")
 #define PROP_RNG_SOL \
-  PROP_RNG_STR5 ("CroutLU", "DoolittleLU", "HouseholderQR", \
-		 "HouseholderLQ", "GolubSVD")
+  PROP_RNG_STR6 ("CroutLU", "DoolittleLU", "HouseholderQR", \
+		 "HouseholderLQ", "GolubSVD", "SparseLU")
 #define PROP_RNG_DIS \
   PROP_RNG_STR7 ("Kirschning", "Kobayashi", "Yamashita", "Getsinger", \
 		 "Schneider", "Pramanick", "Hammerstad")
@@ -53,6 +53,7 @@ parasweep::parasweep () : analysis () {
   var = NULL;
   swp = NULL;
   eqn = NULL;
+  point = 0;
   type = ANALYSIS_SWEEP;
 }
 
@@ -61,6 +62,7 @@ parasweep::parasweep (char * n) : analysis (n) {
   var = NULL;
   swp = NULL;
   eqn = NULL;
+  point = 0;
   type = ANALYSIS_SWEEP;
 }
 
@@ -74,6 +76,7 @@ parasweep::~parasweep () {
 parasweep::parasweep (parasweep & p) : analysis (p) {
   var = new variable (*p.var);
   if (p.swp) swp = new sweep (*p.swp);
+  point = p.point;
 }
 
 // Short macro in order to obtain the correct constant value.
@@ -113,11 +116,17 @@ int parasweep::initialize (void) {
   env->setDoubleConstant (n, v);
   env->setDouble (n, v);
 
-  // also run initialize functionality for all children
+  // also run initialize functionality for all children, these
+  // continue from one sweep point to the next if requested
+  bool cont = !strcmp (getPropertyString ("Continuation"), "yes");
   if (actions != nullptr) {
     for (auto *a : *actions) {
       a->initialize ();
       a->setProgress (false);
+      if (cont) {
+	a->setWarmStart (true);
+	a->setContinuation (this);
+      }
     }
   }
   return 0;
@@ -146,8 +155,10 @@ int parasweep::solve (void) {
   int err = 0;
   runs++;
 
-  // get fixed simulation properties
-  const char * const n = getPropertyString ("Param");
+  // run the parameter sweep in several processes if requested
+  int workers = getPropertyInteger ("Workers");
+  if (workers > 1 && swp->getSize () > 2)
+    return solveParallel (workers);
 
   // run the parameter sweep
   swp->reset ();
@@ -156,24 +167,82 @@ int parasweep::solve (void) {
     nr_double_t v = swp->next ();
     // display progress bar if requested
     if (progress) logprogressbar (i, swp->getSize (), 40);
-    // update environment and equation checker, then run solver
-    env->setDoubleConstant (n, v);
-    env->setDouble (n, v);
-    env->runSolver ();
-    // save results (swept parameter values)
-    if (runs == 1) saveResults ();
+    point = i;
+    err |= solvePoint (v);
+  }
+  // clear progress bar
+  if (progress) logprogressclear (40);
+  return err;
+}
+
+/* The function runs the child analyses for a single sweep value. */
+int parasweep::solvePoint (nr_double_t v) {
+  int err = 0;
+
+  // update environment and equation checker, then run solver
+  setSweepValue (v);
+  // save results (swept parameter values)
+  if (runs == 1) saveResults ();
 #if DEBUG
-    logprint (LOG_STATUS, "NOTIFY: %s: running netlist for %s = %g\n",
-	      getName (), n, v);
+  logprint (LOG_STATUS, "NOTIFY: %s: running netlist for %s = %g\n",
+	    getName (), var->getName (), v);
 #endif
-    for (auto *a : *actions) {
-      err |= a->solve ();
-      // assign variable dataset dependencies to last order analyses
-      ptrlist<analysis> * lastorder = subnet->findLastOrderChildren (this);
-      for (auto *dep : *lastorder)
-	data->assignDependency (dep->getName (), var->getName ());
-    }
+  for (auto *a : *actions) {
+    err |= a->solve ();
+    // assign variable dataset dependencies to last order analyses
+    ptrlist<analysis> * lastorder = subnet->findLastOrderChildren (this);
+    for (auto *dep : *lastorder)
+      data->assignDependency (dep->getName (), var->getName ());
+  }
+  return err;
+}
+
+/* The function runs the child analyses for the given slice of sweep
+   points. */
+int parasweep::solvePoints (int from, int to) {
+  int err = 0;
+  for (int i = from; i < to; i++) {
+    point = i - from;
+    err |= solvePoint (swp->get (i));
   }
+  return err;
+}
+
+/* The function returns the current value of the swept parameter. */
+nr_double_t parasweep::getSweepValue (void) {
+  return D (var->getConstant ());
+}
+
+/* This function sets the swept parameter to the given value in the
+   environment and the equation checker and evaluates the equations
+   depending on it. */
+void parasweep::setSweepValue (nr_double_t v) {
+  const char * const n = getPropertyString ("Param");
+  env->setDoubleConstant (n, v);
+  env->setDouble (n, v);
+  env->runSolver ();
+}
+
+/* The parallel parameter sweep solves the first sweep point in this
+   process, which creates all the output vectors.  The remaining
+   points are solved by forked worker processes, each owning a private
+   copy of the netlist, the environment and the analyses. */
+int parasweep::solveParallel (int workers) {
+  int err = 0;
+  int points = swp->getSize ();
+
+  // the first sweep point creates the dataset vectors
+  swp->reset ();
+  if (progress) logprogressbar (0, points, 40);
+  point = 0;
+  err |= solvePoint (swp->next ());
+
+  // the remaining points are merged in sweep order
+  err |= solveWorkers (workers, 1, points);
+
+  // leave the environment at the last sweep value
+  setSweepValue (swp->get (points - 1));
+
   // clear progress bar
   if (progress) logprogressclear (40);
   return err;
@@ -204,6 +273,8 @@ PROP_OPT [] = {
   { "Stop", PROP_REAL, { 50, PROP_NO_STR }, PROP_NO_RANGE },
   { "Start", PROP_REAL, { 5, PROP_NO_STR }, PROP_NO_RANGE },
   { "Values", PROP_LIST, { 5, PROP_NO_STR }, PROP_NO_RANGE },
+  { "Workers", PROP_INT, { 1, PROP_NO_STR }, PROP_MIN_VAL (1) },
+  { "Continuation", PROP_STR, { PROP_NO_VAL, "no" }, PROP_RNG_YESNO },
   PROP_NO_PROP };
 struct define_t parasweep::anadef =
   { "SW", 0, PROP_ACTION, PROP_NO_SUBSTRATE, PROP_LINEAR, PROP_DEF };
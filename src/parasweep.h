@@ -42,11 +42,20 @@ class parasweep : public analysis
   int  solve (void);
   int  cleanup (void);
   void saveResults (void);
+  int  getSweepPoint (void) { return point; }
+  nr_double_t getSweepValue (void);
+  void setSweepValue (nr_double_t);
+
+ private:
+  int  solvePoint (nr_double_t);
+  int  solvePoints (int, int);
+  int  solveParallel (int);
 
  private:
   variable * var;
   sweep * swp;
   void * eqn;
+  int point;
 };
 
 } // namespace qucs
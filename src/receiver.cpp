@@ -83,9 +83,9 @@ nr_double_t emi::f_gauss (nr_double_t fc, nr_double_t bw, nr_double_t f) {
 }
 
 /* The function computes a EMI receiver spectrum based on the given
-   waveform in the time domain.  The number of points in the waveform
-   is required to be a power of two.  Also the samples are supposed
-   to be equidistant. */
+   real valued waveform in the time domain.  The array must hold two
+   more items than the number of points.  Also the samples are
+   supposed to be equidistant. */
 vector * emi::receiver (nr_double_t * ida, nr_double_t duration, int ilength) {
 
   int i, n, points;
@@ -94,8 +94,7 @@ vector * emi::receiver (nr_double_t * ida, nr_double_t duration, int ilength) {
 
   points = ilength;
 
-  /* ilength must be a power of 2 - write wrapper later on */
-  fourier::_fft_1d (ida, ilength, 1); /* 1 = forward fft */
+  fourier::_rfft_1d (ida, ilength); /* forward fft of real data */
 
   /* start at first AC point (0 as DC point remains untouched)
      additionally only half of the FFT result required */
@@ -205,12 +204,11 @@ vector * emi::receiver (vector * da, vector * dt, int len) {
   inter->prepare (INTERPOL_CUBIC, REPEAT_NO, DATA_RECTANGULAR);
 
   // adjust the time domain vector using interpolation
-  nr_double_t * ida = new nr_double_t[2 * nlen];
+  nr_double_t * ida = new nr_double_t[nlen + 2];
   nr_double_t tstep = duration / (nlen - 1);
   for (i = 0; i < nlen; i++) {
     nr_double_t t = i * tstep + tstart;
-    ida[2 * i + 0] = inter->rinterpolate (t);
-    ida[2 * i + 1] = 0;
+    ida[i] = inter->rinterpolate (t);
   }
 
   // destroy interpolator
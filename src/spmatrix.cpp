@@ -0,0 +1,205 @@
+/*
+ * spmatrix.cpp - sparse matrix template class implementation
+ *
+ * Copyright (C) 2026 Qucs Team
+ *
+ * This is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2, or (at your option)
+ * any later version.
+ *
+ * This software is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this package; see the file COPYING.  If not, write to
+ * the Free Software Foundation, Inc., 51 Franklin Street - Fifth Floor,
+ * Boston, MA 02110-1301, USA.
+ *
+ * $Id$
+ *
+ */
+
+#ifdef HAVE_CONFIG_H
+#include "config.h"
+#else
+// BUG
+#include "qucs_typedefs.h"
+#endif
+
+#include <assert.h>
+#include <stdio.h>
+#include <cmath>
+#include <algorithm>
+
+#include "compat.h"
+#include "logging.h"
+#include "complex.h"
+#include "spmatrix.h"
+
+namespace qucs {
+
+// Constructor creates an unnamed instance of the spmatrix class.
+template <class nr_type_t>
+spmatrix<nr_type_t>::spmatrix () {
+  rows = cols = 0;
+  colptr.assign (1, 0);
+}
+
+/* Constructor creates an unnamed instance of the spmatrix class with
+   the given size.  The matrix has no entries until compress() has
+   been called. */
+template <class nr_type_t>
+spmatrix<nr_type_t>::spmatrix (int s) {
+  rows = cols = s;
+  colptr.assign (s + 1, 0);
+}
+
+/* The function marks the given matrix position as structurally
+   non-zero.  The entry becomes available after the next call to
+   compress(). */
+template <class nr_type_t>
+void spmatrix<nr_type_t>::insert (int r, int c) {
+  assert (r >= 0 && r < rows && c >= 0 && c < cols);
+  pending.push_back (std::make_pair (c, r));
+}
+
+/* This function merges the inserted entries into the compressed
+   column structure.  Duplicate entries are dropped, previous values
+   are kept and new entries are set to zero. */
+template <class nr_type_t>
+void spmatrix<nr_type_t>::compress (void) {
+  if (pending.empty ()) return;
+
+  // collect already existing entries
+  for (int c = 0; c < cols; c++) {
+    for (int p = colptr[c]; p < colptr[c + 1]; p++) {
+      pending.push_back (std::make_pair (c, rowidx[p]));
+    }
+  }
+  std::sort (pending.begin (), pending.end ());
+  pending.erase (std::unique (pending.begin (), pending.end ()),
+		 pending.end ());
+
+  // rebuild the structure keeping the values of existing entries
+  std::vector<int> nrowidx (pending.size ());
+  std::vector<nr_type_t> ndata (pending.size (), 0.0);
+  std::vector<int> ncolptr (cols + 1, 0);
+  for (std::size_t i = 0; i < pending.size (); i++) {
+    int c = pending[i].first, r = pending[i].second;
+    int p = find (r, c);
+    ncolptr[c + 1]++;
+    nrowidx[i] = r;
+    if (p >= 0) ndata[i] = data[p];
+  }
+  for (int c = 0; c < cols; c++) ncolptr[c + 1] += ncolptr[c];
+  colptr.swap (ncolptr);
+  rowidx.swap (nrowidx);
+  data.swap (ndata);
+  pending.clear ();
+}
+
+/* The function returns the position of the given entry in the value
+   array or -1 if the entry is structurally zero. */
+template <class nr_type_t>
+int spmatrix<nr_type_t>::find (int r, int c) const {
+  assert (r >= 0 && r < rows && c >= 0 && c < cols);
+  if (rowidx.empty ()) return -1;
+  const int * first = rowidx.data () + colptr[c];
+  const int * last  = rowidx.data () + colptr[c + 1];
+  const int * it = std::lower_bound (first, last, r);
+  if (it != last && *it == r) return (int) (it - rowidx.data ());
+  return -1;
+}
+
+// Returns the matrix element at the given row and column.
+template <class nr_type_t>
+nr_type_t spmatrix<nr_type_t>::get (int r, int c) const {
+  int p = find (r, c);
+  return p >= 0 ? data[p] : nr_type_t (0.0);
+}
+
+/* Sets the matrix element at the given row and column.  Only entries
+   of the structure may receive non-zero values. */
+template <class nr_type_t>
+void spmatrix<nr_type_t>::set (int r, int c, nr_type_t z) {
+  int p = find (r, c);
+  if (p >= 0)
+    data[p] = z;
+  else
+    assert (z == nr_type_t (0.0));
+}
+
+// Sets all the structurally non-zero elements to the given value.
+template <class nr_type_t>
+void spmatrix<nr_type_t>::set (nr_type_t z) {
+  std::fill (data.begin (), data.end (), z);
+}
+
+/* Adds the given value to the matrix element at the given row and
+   column. */
+template <class nr_type_t>
+void spmatrix<nr_type_t>::add (int r, int c, nr_type_t z) {
+  int p = find (r, c);
+  if (p >= 0)
+    data[p] += z;
+  else
+    assert (z == nr_type_t (0.0));
+}
+
+/* Transpose the matrix in place.  For structurally symmetric matrices
+   (as the MNA matrices are) the structure remains unchanged. */
+template <class nr_type_t>
+void spmatrix<nr_type_t>::transpose (void) {
+  std::vector<int> ncolptr (cols + 1, 0);
+  std::vector<int> nrowidx (data.size ());
+  std::vector<nr_type_t> ndata (data.size ());
+  int c, p;
+
+  // count entries per row, i.e. per column of the transpose
+  for (p = 0; p < (int) rowidx.size (); p++) ncolptr[rowidx[p] + 1]++;
+  for (c = 0; c < cols; c++) ncolptr[c + 1] += ncolptr[c];
+
+  // scatter entries, rows come out sorted since columns are traversed
+  std::vector<int> next (ncolptr.begin (), ncolptr.end () - 1);
+  for (c = 0; c < cols; c++) {
+    for (p = colptr[c]; p < colptr[c + 1]; p++) {
+      int q = next[rowidx[p]]++;
+      nrowidx[q] = c;
+      ndata[q] = data[p];
+    }
+  }
+  colptr.swap (ncolptr);
+  rowidx.swap (nrowidx);
+  data.swap (ndata);
+}
+
+// Checks validity of matrix.
+template <class nr_type_t>
+int spmatrix<nr_type_t>::isFinite (void) {
+  for (int i = 0; i < (int) data.size (); i++)
+    if (!std::isfinite (real (data[i]))) return 0;
+  return 1;
+}
+
+#ifdef DEBUG
+// Debug function: Prints the matrix object.
+template <class nr_type_t>
+void spmatrix<nr_type_t>::print (bool realonly) {
+  for (int c = 0; c < cols; c++) {
+    for (int p = colptr[c]; p < colptr[c + 1]; p++) {
+      if (realonly) {
+	fprintf (stderr, "(%d,%d) %+.2e\n", rowidx[p], c,
+		 (double) real (data[p]));
+      } else {
+	fprintf (stderr, "(%d,%d) %+.2e%+.2ei\n", rowidx[p], c,
+		 (double) real (data[p]), (double) imag (data[p]));
+      }
+    }
+  }
+}
+#endif /* DEBUG */
+
+} // namespace qucs
@@ -0,0 +1,81 @@
+/*
+ * spmatrix.h - sparse matrix template class definitions
+ *
+ * Copyright (C) 2026 Qucs Team
+ *
+ * This is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2, or (at your option)
+ * any later version.
+ *
+ * This software is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this package; see the file COPYING.  If not, write to
+ * the Free Software Foundation, Inc., 51 Franklin Street - Fifth Floor,
+ * Boston, MA 02110-1301, USA.
+ *
+ * $Id$
+ *
+ */
+
+#ifndef __SPMATRIX_H__
+#define __SPMATRIX_H__
+
+#include <vector>
+#include <utility>
+#include <assert.h>
+
+namespace qucs {
+
+/*! The spmatrix class stores a square matrix in compressed sparse
+   column (CSC) format.  The structure is collected by insert() calls
+   and fixed by compress(); afterwards only the values of existing
+   entries can be modified. */
+template <class nr_type_t>
+class spmatrix
+{
+ public:
+  spmatrix ();
+  spmatrix (int);
+  spmatrix (const spmatrix &) = default;
+  spmatrix& operator = (const spmatrix &) = default;
+  ~spmatrix () = default;
+  void insert (int, int);
+  void compress (void);
+  int  find (int, int) const;
+  nr_type_t get (int, int) const;
+  void set (int, int, nr_type_t);
+  void set (nr_type_t);
+  void add (int, int, nr_type_t);
+  int  getCols (void) const { return cols; }
+  int  getRows (void) const { return rows; }
+  int  getNonZeros (void) const { return (int) data.size (); }
+  const int * getColPtr (void) const { return colptr.data (); }
+  const int * getRowIdx (void) const { return rowidx.data (); }
+  nr_type_t * getData (void) { return data.data (); }
+  void transpose (void);
+  int  isFinite (void);
+  void print (bool realonly = false);
+
+  // easy accessor operators
+  nr_type_t  operator [] (int i) const { return data[i]; }
+  nr_type_t& operator [] (int i) { return data[i]; }
+
+ private:
+  int cols;
+  int rows;
+  std::vector<int> colptr;
+  std::vector<int> rowidx;
+  std::vector<nr_type_t> data;
+  std::vector<std::pair<int,int>> pending;
+};
+
+} // namespace qucs
+
+#include "spmatrix.cpp"
+
+#endif /* __SPMATRIX_H__ */
@@ -565,8 +565,6 @@ void spsolver::init (void) {
 /* This is the netlist solver.  It prepares the circuit list for each
    requested frequency and solves it then. */
 int spsolver::solve (void) {
-  nr_double_t freq;
-  int ports;
   runs++;
 
   // fetch simulation properties
@@ -597,9 +595,34 @@ int spsolver::solve (void) {
   logprint (LOG_STATUS, "NOTIFY: %s: solving SP netlist\n", getName ());
 #endif
 
-  swp->reset ();
-  for (int i = 0; i < swp->getSize (); i++) {
-    freq = swp->next ();
+  // solve the frequency points in several processes if requested
+  int err = 0;
+  int points = swp->getSize ();
+  int workers = getPropertyInteger ("Workers");
+  if (workers > 1 && points > 2) {
+    // the first frequency creates the dataset vectors
+    err |= solvePoints (0, 1);
+    err |= solveWorkers (workers, 1, points);
+  }
+  else {
+    err |= solvePoints (0, points);
+  }
+  if (progress) logprogressclear (40);
+  dropConnections ();
+#if SORTED_LIST
+  delete nlist; nlist = NULL;
+#endif
+  return err;
+}
+
+/* The function computes the S-parameters of the netlist for the
+   given slice of frequencies and saves the results. */
+int spsolver::solvePoints (int from, int to) {
+  nr_double_t freq;
+  int ports;
+
+  for (int i = from; i < to; i++) {
+    freq = swp->get (i);
     if (progress) logprogressbar (i, swp->getSize (), 40);
 
     ports = subnet->countNodes ();
@@ -621,11 +644,6 @@ int spsolver::solve (void) {
     subnet->deleteUnusedCircuits (nlist);
     if (saveCVs & SAVE_CVS) saveCharacteristics (freq);
   }
-  if (progress) logprogressclear (40);
-  dropConnections ();
-#if SORTED_LIST
-  delete nlist; nlist = NULL;
-#endif
   return 0;
 }
 
@@ -1115,6 +1133,7 @@ PROP_OPT [] = {
   { "Values", PROP_LIST, { 10, PROP_NO_STR }, PROP_POS_RANGE },
   { "saveCVs", PROP_STR, { PROP_NO_VAL, "no" }, PROP_RNG_YESNO },
   { "saveAll", PROP_STR, { PROP_NO_VAL, "no" }, PROP_RNG_YESNO },
+  { "Workers", PROP_INT, { 1, PROP_NO_STR }, PROP_MIN_VAL (1) },
   PROP_NO_PROP };
 struct define_t spsolver::anadef =
   { "SP", 0, PROP_ACTION, PROP_NO_SUBSTRATE, PROP_LINEAR, PROP_DEF };
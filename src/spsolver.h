@@ -47,6 +47,7 @@ class spsolver : public analysis
   void init (void);
   void reduce (void);
   int  solve (void);
+  int  solvePoints (int, int);
   void insertConnections (void);
   void insertDifferentialPorts (void);
   void insertTee (node **, const char *);
@@ -0,0 +1,697 @@
+/*
+ * tape.cpp - compiled equation tape class implementation
+ *
+ * Copyright (C) 2026 Qucs Team
+ *
+ * This is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2, or (at your option)
+ * any later version.
+ *
+ * This software is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this package; see the file COPYING.  If not, write to
+ * the Free Software Foundation, Inc., 51 Franklin Street - Fifth Floor,
+ * Boston, MA 02110-1301, USA.
+ *
+ */
+
+#if HAVE_CONFIG_H
+# include <config.h>
+#endif
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <cmath>
+#include <algorithm>
+
+#include "logging.h"
+#include "complex.h"
+#include "object.h"
+#include "constants.h"
+#include "fspecial.h"
+#include "equation.h"
+#include "evaluate.h"
+#include "exception.h"
+#include "exceptionstack.h"
+#include "tape.h"
+
+using namespace qucs;
+using namespace qucs::eqn;
+using namespace fspecial;
+
+#define A(a) ((assignment *) (a))
+#define C(c) ((constant *) (c))
+#define R(r) ((reference *) (r))
+
+// Throws a math exception.
+#define THROW_MATH_EXCEPTION(txt) do { \
+  qucs::exception * e = new qucs::exception (EXCEPTION_MATH); \
+  e->setText (txt); throw_exception (e); } while (0)
+
+/* Instruction codes of the tape.  Real valued (including boolean)
+   operands live on the double stack, complex ones on the complex
+   stack; both stacks share the same stack pointer. */
+enum tape_opcode {
+  OP_NOP = 0,
+  OP_PUSH_D,      // push double immediate
+  OP_PUSH_C,      // push complex immediate
+  OP_LOAD,        // push value of a constant
+  OP_LOAD_C,
+  OP_LOADREF,     // push result of a referenced equation
+  OP_LOADREF_C,
+  OP_EVAL,        // evaluate sub-tree by the equation interpreter
+  OP_EVAL_C,
+  OP_UPDATE,      // re-evaluate skipped equation by the interpreter
+  OP_TOCOMPLEX,   // convert top of stack into a complex value
+
+  // real operations
+  OP_NEG_D, OP_ADD_DD, OP_SUB_DD, OP_MUL_DD, OP_DIV_DD, OP_POW_DD,
+  OP_EXP_D, OP_LIMEXP_D, OP_SIN_D, OP_COS_D, OP_TAN_D, OP_SINH_D,
+  OP_COSH_D, OP_TANH_D, OP_ATAN_D, OP_SQR_D, OP_SIGN_D, OP_ABS_D,
+  OP_VT_D, OP_MAX_DD, OP_MIN_DD, OP_IF_D,
+  OP_LT, OP_GT, OP_LE, OP_GE, OP_EQ, OP_NE, OP_NOT, OP_OR, OP_AND,
+
+  // real to complex operations
+  OP_SQRT_D, OP_LN_D, OP_LOG10_D,
+
+  // complex operations
+  OP_NEG_C, OP_ADD_CC, OP_ADD_CD, OP_ADD_DC, OP_SUB_CC, OP_SUB_CD,
+  OP_SUB_DC, OP_MUL_CC, OP_MUL_CD, OP_MUL_DC, OP_DIV_CC, OP_DIV_CD,
+  OP_DIV_DC, OP_POW_CC, OP_POW_CD, OP_POW_DC, OP_EXP_C, OP_SQRT_C,
+  OP_LN_C, OP_IF_C,
+
+  // complex to real operations
+  OP_REAL_C, OP_IMAG_C, OP_ABS_C
+};
+
+/* The list of known evaluator functions.  The argument kinds are 'd'
+   for doubles, 'b' for booleans, 'c' for complex values and 'x' for
+   any scalar being converted into a complex value.  The result is
+   either real or complex. */
+struct tape_function {
+  evaluator_t eval;
+  int op;
+  const char * args;
+  int complex;
+};
+
+static struct tape_function tape_functions[] = {
+  { evaluate::plus_d,             OP_NOP,      "d",   0 },
+  { evaluate::plus_c,             OP_NOP,      "c",   1 },
+  { evaluate::minus_d,            OP_NEG_D,    "d",   0 },
+  { evaluate::minus_c,            OP_NEG_C,    "c",   1 },
+  { evaluate::plus_d_d,           OP_ADD_DD,   "dd",  0 },
+  { evaluate::plus_c_c,           OP_ADD_CC,   "cc",  1 },
+  { evaluate::plus_c_d,           OP_ADD_CD,   "cd",  1 },
+  { evaluate::plus_d_c,           OP_ADD_DC,   "dc",  1 },
+  { evaluate::minus_d_d,          OP_SUB_DD,   "dd",  0 },
+  { evaluate::minus_c_c,          OP_SUB_CC,   "cc",  1 },
+  { evaluate::minus_c_d,          OP_SUB_CD,   "cd",  1 },
+  { evaluate::minus_d_c,          OP_SUB_DC,   "dc",  1 },
+  { evaluate::times_d_d,          OP_MUL_DD,   "dd",  0 },
+  { evaluate::times_c_c,          OP_MUL_CC,   "cc",  1 },
+  { evaluate::times_c_d,          OP_MUL_CD,   "cd",  1 },
+  { evaluate::times_d_c,          OP_MUL_DC,   "dc",  1 },
+  { evaluate::over_d_d,           OP_DIV_DD,   "dd",  0 },
+  { evaluate::over_c_c,           OP_DIV_CC,   "cc",  1 },
+  { evaluate::over_c_d,           OP_DIV_CD,   "cd",  1 },
+  { evaluate::over_d_c,           OP_DIV_DC,   "dc",  1 },
+  { evaluate::power_d_d,          OP_POW_DD,   "dd",  0 },
+  { evaluate::power_c_c,          OP_POW_CC,   "cc",  1 },
+  { evaluate::power_c_d,          OP_POW_CD,   "cd",  1 },
+  { evaluate::power_d_c,          OP_POW_DC,   "dc",  1 },
+  { evaluate::exp_d,              OP_EXP_D,    "d",   0 },
+  { evaluate::exp_c,              OP_EXP_C,    "c",   1 },
+  { evaluate::limexp_d,           OP_LIMEXP_D, "d",   0 },
+  { evaluate::sin_d,              OP_SIN_D,    "d",   0 },
+  { evaluate::cos_d,              OP_COS_D,    "d",   0 },
+  { evaluate::tan_d,              OP_TAN_D,    "d",   0 },
+  { evaluate::sinh_d,             OP_SINH_D,   "d",   0 },
+  { evaluate::cosh_d,             OP_COSH_D,   "d",   0 },
+  { evaluate::tanh_d,             OP_TANH_D,   "d",   0 },
+  { evaluate::arctan_d,           OP_ATAN_D,   "d",   0 },
+  { evaluate::sqr_d,              OP_SQR_D,    "d",   0 },
+  { evaluate::sign_d,             OP_SIGN_D,   "d",   0 },
+  { evaluate::abs_d,              OP_ABS_D,    "d",   0 },
+  { evaluate::abs_c,              OP_ABS_C,    "c",   0 },
+  { evaluate::real_d,             OP_NOP,      "d",   0 },
+  { evaluate::real_c,             OP_REAL_C,   "c",   0 },
+  { evaluate::imag_c,             OP_IMAG_C,   "c",   0 },
+  { evaluate::sqrt_d,             OP_SQRT_D,   "d",   1 },
+  { evaluate::sqrt_c,             OP_SQRT_C,   "c",   1 },
+  { evaluate::ln_d,               OP_LN_D,     "d",   1 },
+  { evaluate::ln_c,               OP_LN_C,     "c",   1 },
+  { evaluate::log10_d,            OP_LOG10_D,  "d",   1 },
+  { evaluate::vt_d,               OP_VT_D,     "d",   0 },
+  { evaluate::max_d_d,            OP_MAX_DD,   "dd",  0 },
+  { evaluate::min_d_d,            OP_MIN_DD,   "dd",  0 },
+  { evaluate::ifthenelse_d_d,     OP_IF_D,     "bdd", 0 },
+  { evaluate::ifthenelse_b_d,     OP_IF_D,     "bbd", 0 },
+  { evaluate::ifthenelse_d_b,     OP_IF_D,     "bdb", 0 },
+  { evaluate::ifthenelse_c_c,     OP_IF_C,     "bxx", 1 },
+  { evaluate::less_d_d,           OP_LT,       "dd",  0 },
+  { evaluate::greater_d_d,        OP_GT,       "dd",  0 },
+  { evaluate::lessorequal_d_d,    OP_LE,       "dd",  0 },
+  { evaluate::greaterorequal_d_d, OP_GE,       "dd",  0 },
+  { evaluate::equal_d_d,          OP_EQ,       "dd",  0 },
+  { evaluate::notequal_d_d,       OP_NE,       "dd",  0 },
+  { evaluate::not_b,              OP_NOT,      "b",   0 },
+  { evaluate::or_b_b,             OP_OR,       "bb",  0 },
+  { evaluate::and_b_b,            OP_AND,      "bb",  0 },
+  { NULL, OP_NOP, NULL, 0 }
+};
+
+// Constructor creates an empty tape.
+tape::tape () {
+  dstack = NULL;
+  cstack = NULL;
+  depth = size = 0;
+  type = TAG_UNKNOWN;
+  root = NULL;
+}
+
+// Constructor creates a tape for the given equation.
+tape::tape (node * n) {
+  dstack = NULL;
+  cstack = NULL;
+  depth = size = 0;
+  type = TAG_UNKNOWN;
+  root = NULL;
+  compile (n);
+}
+
+// Destructor deletes the tape.
+tape::~tape () {
+  free (dstack);
+  delete[] cstack;
+}
+
+/* This function compiles the given equation (usually an assignment)
+   into the tape.  It returns non-zero if the equation could be
+   compiled.  Otherwise the tape falls back to the evaluation of the
+   equation tree. */
+int tape::compile (node * n) {
+  code.clear ();
+  active.clear ();
+  depth = size = 0;
+  root = n;
+  type = TAG_UNKNOWN;
+  if (n == NULL) return 0;
+
+  // compile body of assignments, but keep the assignment as root
+  node * body = n;
+  if (n->getTag () == ASSIGNMENT) {
+    active.push_back (n);
+    body = A(n)->body;
+  }
+  type = n->getType ();
+  int t = compileNode (body);
+  if (t == TAG_UNKNOWN)
+    code.clear ();
+  else
+    type = t;
+  active.clear ();
+
+  // allocate the value stacks once
+  free (dstack);
+  delete[] cstack;
+  dstack = NULL;
+  cstack = NULL;
+  if (!code.empty ()) {
+    dstack = (nr_double_t *) calloc (depth, sizeof (nr_double_t));
+    cstack = new nr_complex_t[depth];
+  }
+  return !code.empty ();
+}
+
+// Appends an instruction changing the stack depth by the given delta.
+void tape::emit (int op, int delta, node * n, nr_double_t d,
+		 nr_complex_t c) {
+  instruction i;
+  i.op = op;
+  i.d = d;
+  i.c = c;
+  i.n = n;
+  code.push_back (i);
+  size += delta;
+  depth = std::max (depth, size);
+}
+
+/* Emits re-evaluations of all skipped equations the given sub-tree
+   depends on.  These equations are not evaluated by the equation
+   solver and their results must be up to date before the sub-tree
+   gets evaluated by the interpreter. */
+void tape::compileUpdates (node * n) {
+  switch (n->getTag ()) {
+  case APPLICATION:
+    for (node * arg = ((application *) n)->args; arg; arg = arg->getNext ())
+      compileUpdates (arg);
+    break;
+  case REFERENCE: {
+    n->solvee = root->solvee;
+    R(n)->findVariable ();
+    node * target = R(n)->ref;
+    if (target == NULL || !A(target)->skip ||
+	A(target)->body->getTag () == CONSTANT)
+      break;
+    if (std::find (active.begin (), active.end (), target) != active.end ())
+      break;
+    active.push_back (target);
+    compileUpdates (A(target)->body);
+    active.pop_back ();
+    emit (OP_UPDATE, 0, target);
+    break;
+  }
+  default:
+    break;
+  }
+}
+
+/* Compiles the given node and returns the type of the value pushed
+   onto the stack or TAG_UNKNOWN if nothing could be compiled. */
+int tape::compileNode (node * n) {
+  size_t mark = code.size ();
+  int sp = size, t = TAG_UNKNOWN;
+
+  // as done by the interpreter
+  n->solvee = root->solvee;
+
+  switch (n->getTag ()) {
+  case CONSTANT:
+    switch (t = C(n)->getType ()) {
+    case TAG_DOUBLE:
+      emit (OP_PUSH_D, 1, n, C(n)->d);
+      break;
+    case TAG_BOOLEAN:
+      emit (OP_PUSH_D, 1, n, C(n)->b ? 1.0 : 0.0);
+      break;
+    case TAG_COMPLEX:
+      emit (OP_PUSH_C, 1, n, 0.0, *(C(n)->c));
+      break;
+    default:
+      t = TAG_UNKNOWN;
+      break;
+    }
+    break;
+  case REFERENCE: {
+    R(n)->findVariable ();
+    node * target = R(n)->ref;
+    if (target == NULL) break;
+    node * body = A(target)->body;
+    t = body->getType ();
+    if (t != TAG_DOUBLE && t != TAG_COMPLEX && t != TAG_BOOLEAN) {
+      t = TAG_UNKNOWN;
+      break;
+    }
+    // constants (e.g. branch voltages) are modified in place
+    if (body->getTag () == CONSTANT) {
+      emit (t == TAG_COMPLEX ? OP_LOAD_C : OP_LOAD, 1, body);
+    }
+    // inline equations which are not evaluated by the solver
+    else if (A(target)->skip &&
+	     std::find (active.begin (), active.end (), target) ==
+	     active.end ()) {
+      active.push_back (target);
+      t = compileNode (body);
+      active.pop_back ();
+    }
+    // otherwise use the result of the last solver run
+    else {
+      emit (t == TAG_COMPLEX ? OP_LOADREF_C : OP_LOADREF, 1, body);
+    }
+    break;
+  }
+  case APPLICATION:
+    t = compileApplication (n);
+    break;
+  }
+
+  // fall back to the interpreter for this sub-tree
+  if (t == TAG_UNKNOWN) {
+    code.resize (mark);
+    size = sp;
+    t = n->getType ();
+    if (t != TAG_DOUBLE && t != TAG_COMPLEX && t != TAG_BOOLEAN)
+      return TAG_UNKNOWN;
+    compileUpdates (n);
+    emit (t == TAG_COMPLEX ? OP_EVAL_C : OP_EVAL, 1, n);
+  }
+  return t;
+}
+
+/* Compiles an application by looking up its evaluator function.  The
+   arguments are checked against the expected types. */
+int tape::compileApplication (node * n) {
+  application * app = (application *) n;
+  struct tape_function * f;
+
+  if (app->eval == NULL || app->ddx != NULL) return TAG_UNKNOWN;
+  for (f = tape_functions; f->eval != NULL; f++)
+    if (f->eval == app->eval) break;
+  if (f->eval == NULL || (int) strlen (f->args) != app->nargs)
+    return TAG_UNKNOWN;
+
+  // check argument types
+  const char * k = f->args;
+  node * arg;
+  for (arg = app->args; arg != NULL; arg = arg->getNext (), k++) {
+    int t = arg->getType ();
+    if ((*k == 'd' && t != TAG_DOUBLE) ||
+	(*k == 'b' && t != TAG_BOOLEAN) ||
+	(*k == 'c' && t != TAG_COMPLEX) ||
+	(*k == 'x' && t != TAG_DOUBLE && t != TAG_COMPLEX &&
+	 t != TAG_BOOLEAN))
+      return TAG_UNKNOWN;
+  }
+
+  // compile arguments
+  for (k = f->args, arg = app->args; arg != NULL; arg = arg->getNext (), k++) {
+    int t = compileNode (arg);
+    if (t == TAG_UNKNOWN) return TAG_UNKNOWN;
+    if (*k == 'x' && t != TAG_COMPLEX) emit (OP_TOCOMPLEX, 0);
+  }
+
+  // finally the operation itself
+  if (f->op != OP_NOP) emit (f->op, 1 - app->nargs, n);
+  return f->complex ? TAG_COMPLEX : n->getType ();
+}
+
+// Macros for accessing the value stacks.
+#define D0 d[sp]
+#define D1 d[sp - 1]
+#define D2 d[sp - 2]
+#define C0 c[sp]
+#define C1 c[sp - 1]
+#define C2 c[sp - 2]
+#define B(x) ((x) != 0.0)
+
+// Returns a real value from the given constant.
+static inline nr_double_t tape_double (constant * c) {
+  if (c == NULL) return 0.0;
+  switch (c->getType ()) {
+  case TAG_DOUBLE:  return c->d;
+  case TAG_BOOLEAN: return c->b ? 1.0 : 0.0;
+  case TAG_COMPLEX: return real (*(c->c));
+  }
+  return 0.0;
+}
+
+// Returns a complex value from the given constant.
+static inline nr_complex_t tape_complex (constant * c) {
+  if (c == NULL) return 0.0;
+  switch (c->getType ()) {
+  case TAG_DOUBLE:  return nr_complex_t (c->d, 0.0);
+  case TAG_BOOLEAN: return c->b ? 1.0 : 0.0;
+  case TAG_COMPLEX: return *(c->c);
+  }
+  return 0.0;
+}
+
+// Runs the tape leaving the result on the bottom of the stacks.
+void tape::run (void) {
+  nr_double_t * d = dstack;
+  nr_complex_t * c = cstack;
+  instruction * i = code.data ();
+  instruction * end = i + code.size ();
+  int sp = -1;
+
+  for (; i < end; i++) {
+    switch (i->op) {
+    case OP_NOP:
+      break;
+    case OP_PUSH_D:
+      d[++sp] = i->d;
+      break;
+    case OP_PUSH_C:
+      c[++sp] = i->c;
+      break;
+    case OP_LOAD:
+      d[++sp] = tape_double (C(i->n));
+      break;
+    case OP_LOAD_C:
+      c[++sp] = tape_complex (C(i->n));
+      break;
+    case OP_LOADREF:
+      d[++sp] = tape_double (i->n->getResult ());
+      break;
+    case OP_LOADREF_C:
+      c[++sp] = tape_complex (i->n->getResult ());
+      break;
+    case OP_EVAL:
+      i->n->solvee = root->solvee;
+      i->n->evaluate ();
+      d[++sp] = i->n->getResultDouble ();
+      break;
+    case OP_EVAL_C:
+      i->n->solvee = root->solvee;
+      i->n->evaluate ();
+      c[++sp] = i->n->getResultComplex ();
+      break;
+    case OP_UPDATE:
+      i->n->solvee = root->solvee;
+      i->n->evaluate ();
+      break;
+    case OP_TOCOMPLEX:
+      C0 = nr_complex_t (D0, 0.0);
+      break;
+
+    // real operations
+    case OP_NEG_D:
+      D0 = -D0;
+      break;
+    case OP_ADD_DD:
+      D1 = D1 + D0; sp--;
+      break;
+    case OP_SUB_DD:
+      D1 = D1 - D0; sp--;
+      break;
+    case OP_MUL_DD:
+      D1 = D1 * D0; sp--;
+      break;
+    case OP_DIV_DD:
+      if (D0 == 0.0) THROW_MATH_EXCEPTION ("division by zero");
+      D1 = D1 / D0; sp--;
+      break;
+    case OP_POW_DD:
+      D1 = std::pow (D1, D0); sp--;
+      break;
+    case OP_EXP_D:
+      D0 = exp (D0);
+      break;
+    case OP_LIMEXP_D:
+      D0 = limexp (D0);
+      break;
+    case OP_SIN_D:
+      D0 = sin (D0);
+      break;
+    case OP_COS_D:
+      D0 = cos (D0);
+      break;
+    case OP_TAN_D:
+      D0 = tan (D0);
+      break;
+    case OP_SINH_D:
+      D0 = sinh (D0);
+      break;
+    case OP_COSH_D:
+      D0 = cosh (D0);
+      break;
+    case OP_TANH_D:
+      D0 = tanh (D0);
+      break;
+    case OP_ATAN_D:
+      D0 = std::atan (D0);
+      break;
+    case OP_SQR_D:
+      D0 = sqr (D0);
+      break;
+    case OP_SIGN_D:
+      D0 = qucs::sign (D0);
+      break;
+    case OP_ABS_D:
+      D0 = abs (D0);
+      break;
+    case OP_VT_D:
+      D0 = D0 * kBoverQ;
+      break;
+    case OP_MAX_DD:
+      D1 = std::max (D1, D0); sp--;
+      break;
+    case OP_MIN_DD:
+      D1 = std::min (D1, D0); sp--;
+      break;
+    case OP_IF_D:
+      D2 = B (D2) ? D1 : D0; sp -= 2;
+      break;
+    case OP_LT:
+      D1 = D1 < D0 ? 1.0 : 0.0; sp--;
+      break;
+    case OP_GT:
+      D1 = D1 > D0 ? 1.0 : 0.0; sp--;
+      break;
+    case OP_LE:
+      D1 = D1 <= D0 ? 1.0 : 0.0; sp--;
+      break;
+    case OP_GE:
+      D1 = D1 >= D0 ? 1.0 : 0.0; sp--;
+      break;
+    case OP_EQ:
+      D1 = D1 == D0 ? 1.0 : 0.0; sp--;
+      break;
+    case OP_NE:
+      D1 = D1 != D0 ? 1.0 : 0.0; sp--;
+      break;
+    case OP_NOT:
+      D0 = B (D0) ? 0.0 : 1.0;
+      break;
+    case OP_OR:
+      D1 = (B (D1) || B (D0)) ? 1.0 : 0.0; sp--;
+      break;
+    case OP_AND:
+      D1 = (B (D1) && B (D0)) ? 1.0 : 0.0; sp--;
+      break;
+
+    // real to complex operations
+    case OP_SQRT_D:
+      if (D0 < 0.0)
+	C0 = nr_complex_t (0.0, std::sqrt (-D0));
+      else
+	C0 = nr_complex_t (std::sqrt (D0));
+      break;
+    case OP_LN_D:
+      if (D0 < 0.0)
+	C0 = nr_complex_t (std::log (-D0), pi);
+      else
+	C0 = nr_complex_t (std::log (D0));
+      break;
+    case OP_LOG10_D:
+      if (D0 < 0.0)
+	C0 = nr_complex_t (std::log10 (-D0), pi * log10e);
+      else
+	C0 = nr_complex_t (std::log10 (D0));
+      break;
+
+    // complex operations
+    case OP_NEG_C:
+      C0 = -C0;
+      break;
+    case OP_ADD_CC:
+      C1 = C1 + C0; sp--;
+      break;
+    case OP_ADD_CD:
+      C1 = C1 + D0; sp--;
+      break;
+    case OP_ADD_DC:
+      C1 = D1 + C0; sp--;
+      break;
+    case OP_SUB_CC:
+      C1 = C1 - C0; sp--;
+      break;
+    case OP_SUB_CD:
+      C1 = C1 - D0; sp--;
+      break;
+    case OP_SUB_DC:
+      C1 = D1 - C0; sp--;
+      break;
+    case OP_MUL_CC:
+      C1 = C1 * C0; sp--;
+      break;
+    case OP_MUL_CD:
+      C1 = C1 * D0; sp--;
+      break;
+    case OP_MUL_DC:
+      C1 = D1 * C0; sp--;
+      break;
+    case OP_DIV_CC:
+      if (C0 == 0.0) THROW_MATH_EXCEPTION ("division by zero");
+      C1 = C1 / C0; sp--;
+      break;
+    case OP_DIV_CD:
+      if (D0 == 0.0) THROW_MATH_EXCEPTION ("division by zero");
+      C1 = C1 / D0; sp--;
+      break;
+    case OP_DIV_DC:
+      if (C0 == 0.0) THROW_MATH_EXCEPTION ("division by zero");
+      C1 = D1 / C0; sp--;
+      break;
+    case OP_POW_CC:
+      C1 = std::pow (C1, C0); sp--;
+      break;
+    case OP_POW_CD:
+      C1 = pow (C1, D0); sp--;
+      break;
+    case OP_POW_DC:
+      C1 = pow (D1, C0); sp--;
+      break;
+    case OP_EXP_C:
+      C0 = exp (C0);
+      break;
+    case OP_SQRT_C:
+      C0 = std::sqrt (C0);
+      break;
+    case OP_LN_C:
+      C0 = std::log (C0);
+      break;
+    case OP_IF_C:
+      C2 = B (D2) ? C1 : C0; sp -= 2;
+      break;
+
+    // complex to real operations
+    case OP_REAL_C:
+      D0 = real (C0);
+      break;
+    case OP_IMAG_C:
+      D0 = imag (C0);
+      break;
+    case OP_ABS_C:
+      D0 = abs (C0);
+      break;
+    }
+  }
+}
+
+/* Returns non-zero if the tape reads results of equations evaluated
+   by the equation solver, either directly or through the equation
+   tree interpreter.  Otherwise the solver need not be run before
+   evaluating the tape. */
+int tape::needsSolver (void) {
+  if (code.empty ()) return root != NULL;
+  for (auto i = code.begin (); i != code.end (); ++i) {
+    switch (i->op) {
+    case OP_LOADREF: case OP_LOADREF_C:
+    case OP_EVAL: case OP_EVAL_C: case OP_UPDATE:
+      return 1;
+    }
+  }
+  return 0;
+}
+
+/* Evaluates the equation and returns its real value.  The semantics
+   are the same as for node::getResultDouble(). */
+nr_double_t tape::evalDouble (void) {
+  if (code.empty ()) {
+    if (root == NULL) return 0.0;
+    root->evaluate ();
+    return root->getResultDouble ();
+  }
+  run ();
+  return type == TAG_COMPLEX ? real (cstack[0]) : dstack[0];
+}
+
+/* Evaluates the equation and returns its complex value.  The
+   semantics are the same as for node::getResultComplex(). */
+nr_complex_t tape::evalComplex (void) {
+  if (code.empty ()) {
+    if (root == NULL) return 0.0;
+    root->evaluate ();
+    return root->getResultComplex ();
+  }
+  run ();
+  return type == TAG_COMPLEX ? cstack[0] : nr_complex_t (dstack[0], 0.0);
+}
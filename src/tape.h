@@ -0,0 +1,85 @@
+/*
+ * tape.h - compiled equation tape class definitions
+ *
+ * Copyright (C) 2026 Qucs Team
+ *
+ * This is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2, or (at your option)
+ * any later version.
+ *
+ * This software is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this package; see the file COPYING.  If not, write to
+ * the Free Software Foundation, Inc., 51 Franklin Street - Fifth Floor,
+ * Boston, MA 02110-1301, USA.
+ *
+ */
+
+#ifndef __TAPE_H__
+#define __TAPE_H__
+
+#include <vector>
+
+namespace qucs {
+
+namespace eqn {
+
+class node;
+class constant;
+
+/* The tape class holds an equation compiled into a flat list of
+   instructions operating on a preallocated value stack.  Running the
+   tape neither allocates memory nor re-creates any result constants,
+   which makes it suitable for equations being evaluated in each
+   iteration of a simulation, e.g. the ones of equation defined devices
+   and their derivatives.  Sub-expressions which cannot be compiled are
+   delegated to the usual equation tree evaluation. */
+class tape
+{
+ public:
+  tape ();
+  tape (node *);
+  ~tape ();
+  int compile (node *);
+  int isCompiled (void) { return !code.empty (); }
+  int getSize (void) { return (int) code.size (); }
+  int getType (void) { return type; }
+  int needsSolver (void);
+  nr_double_t evalDouble (void);
+  nr_complex_t evalComplex (void);
+
+ private:
+  struct instruction {
+    int op;
+    nr_double_t d;
+    nr_complex_t c;
+    node * n;
+  };
+  int compileNode (node *);
+  int compileApplication (node *);
+  void compileUpdates (node *);
+  void emit (int, int, node * n = NULL, nr_double_t d = 0.0,
+	     nr_complex_t c = nr_complex_t (0.0, 0.0));
+  void run (void);
+
+ private:
+  std::vector<instruction> code;
+  std::vector<node *> active;
+  nr_double_t * dstack;
+  nr_complex_t * cstack;
+  int depth;
+  int size;
+  int type;
+  node * root;
+};
+
+} /* namespace eqn */
+
+} // namespace qucs
+
+#endif /* __TAPE_H__ */
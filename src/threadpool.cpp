@@ -0,0 +1,107 @@
+/*
+ * threadpool.cpp - thread pool class implementation
+ *
+ * Copyright (C) 2026 Qucs Team
+ *
+ * This is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2, or (at your option)
+ * any later version.
+ *
+ * This software is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this package; see the file COPYING.  If not, write to
+ * the Free Software Foundation, Inc., 51 Franklin Street - Fifth Floor,
+ * Boston, MA 02110-1301, USA.
+ *
+ */
+
+#if HAVE_CONFIG_H
+# include <config.h>
+#endif
+
+#include "threadpool.h"
+
+namespace qucs {
+
+// Constructor starts the given number of threads (including the caller).
+threadpool::threadpool (int n) {
+  threads = n > 1 ? n : 1;
+  task = NULL;
+  tasks = next = pending = 0;
+  batch = 0;
+  quit = false;
+  for (int i = 1; i < threads; i++)
+    workers.push_back (std::thread (&threadpool::work, this));
+}
+
+// Destructor stops and joins all the worker threads.
+threadpool::~threadpool () {
+  {
+    std::lock_guard<std::mutex> l (lock);
+    quit = true;
+  }
+  wakeup.notify_all ();
+  for (unsigned int i = 0; i < workers.size (); i++)
+    workers[i].join ();
+}
+
+/* The function runs the given function for each task index in the
+   range [0,n) and returns once all of them have been completed.  The
+   order of execution is unspecified, so the tasks must not depend on
+   each other. */
+void threadpool::run (int n, const std::function<void (int)> & f) {
+  if (workers.empty ()) {
+    for (int i = 0; i < n; i++) f (i);
+    return;
+  }
+  {
+    std::lock_guard<std::mutex> l (lock);
+    task = &f;
+    tasks = pending = n;
+    next = 0;
+    batch++;
+  }
+  wakeup.notify_all ();
+  execute ();
+  std::unique_lock<std::mutex> l (lock);
+  while (pending > 0) done.wait (l);
+  task = NULL;
+}
+
+// Picks up tasks of the current batch until none is left.
+void threadpool::execute (void) {
+  for (;;) {
+    int i;
+    {
+      std::lock_guard<std::mutex> l (lock);
+      if (next >= tasks) return;
+      i = next++;
+    }
+    (*task) (i);
+    {
+      std::lock_guard<std::mutex> l (lock);
+      if (--pending == 0) done.notify_one ();
+    }
+  }
+}
+
+// The main loop of each worker thread.
+void threadpool::work (void) {
+  unsigned int seen = 0;
+  std::unique_lock<std::mutex> l (lock);
+  for (;;) {
+    while (!quit && batch == seen) wakeup.wait (l);
+    if (quit) return;
+    seen = batch;
+    l.unlock ();
+    execute ();
+    l.lock ();
+  }
+}
+
+} // namespace qucs
@@ -0,0 +1,67 @@
+/*
+ * threadpool.h - thread pool class definitions
+ *
+ * Copyright (C) 2026 Qucs Team
+ *
+ * This is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2, or (at your option)
+ * any later version.
+ *
+ * This software is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this package; see the file COPYING.  If not, write to
+ * the Free Software Foundation, Inc., 51 Franklin Street - Fifth Floor,
+ * Boston, MA 02110-1301, USA.
+ *
+ */
+
+#ifndef __THREADPOOL_H__
+#define __THREADPOOL_H__
+
+#include <vector>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <functional>
+
+namespace qucs {
+
+/* The thread pool class keeps a fixed number of worker threads alive
+   which repeatedly execute a batch of independent tasks.  The calling
+   thread takes part in each batch, i.e. a pool of n threads starts
+   n - 1 additional workers.  A batch returns when all of its tasks
+   have been completed. */
+class threadpool
+{
+ public:
+  threadpool (int);
+  ~threadpool ();
+  int getThreads (void) const { return threads; }
+  void run (int, const std::function<void (int)> &);
+
+ private:
+  void work (void);
+  void execute (void);
+
+ private:
+  int threads;
+  std::vector<std::thread> workers;
+  std::mutex lock;
+  std::condition_variable wakeup;
+  std::condition_variable done;
+  const std::function<void (int)> * task;
+  int tasks;
+  int next;
+  int pending;
+  unsigned int batch;
+  bool quit;
+};
+
+} // namespace qucs
+
+#endif /* __THREADPOOL_H__ */
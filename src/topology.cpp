@@ -0,0 +1,134 @@
+/*
+ * topology.cpp - topology class implementation
+ *
+ * Copyright (C) 2026 Qucs Team
+ *
+ * This is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2, or (at your option)
+ * any later version.
+ *
+ * This software is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this package; see the file COPYING.  If not, write to
+ * the Free Software Foundation, Inc., 51 Franklin Street - Fifth Floor,
+ * Boston, MA 02110-1301, USA.
+ *
+ */
+
+
+#if HAVE_CONFIG_H
+# include <config.h>
+#endif
+
+#include "object.h"
+#include "node.h"
+#include "complex.h"
+#include "circuit.h"
+#include "nodelist.h"
+#include "topology.h"
+
+namespace qucs {
+
+// Constructor creates an empty topology.
+topology::topology () {
+  nodes = 0;
+}
+
+// Destructor deletes the topology.
+topology::~topology () {
+}
+
+// Removes all circuits and nodes from the topology.
+void topology::clear (void) {
+  nodes = 0;
+  circuits.clear ();
+  index.clear ();
+  portStart.assign (1, 0);
+  portNode.clear ();
+  vsource.clear ();
+  termStart.clear ();
+  termCircuit.clear ();
+  termPort.clear ();
+}
+
+/* Appends the given circuit unless already done and returns its
+   index.  The circuit ports are not connected yet. */
+int topology::addCircuit (circuit * c) {
+  std::unordered_map<circuit *, int>::iterator it = index.find (c);
+  if (it != index.end ()) return it->second;
+  int i = (int) circuits.size ();
+  circuits.push_back (c);
+  index[c] = i;
+  portStart.push_back (portStart.back () + c->getSize ());
+  portNode.resize (portStart.back (), -1);
+  vsource.push_back (c->getVoltageSource ());
+  return i;
+}
+
+// Returns the index of the given circuit or -1 if there is no such.
+int topology::getIndex (circuit * c) const {
+  std::unordered_map<circuit *, int>::const_iterator it = index.find (c);
+  return it != index.end () ? it->second : -1;
+}
+
+/* The function creates the topology from the given enumerated node
+   list.  The terminals of each node keep the order of the node list,
+   the circuits are indexed in the order of their first appearance. */
+void topology::create (nodelist * nlist) {
+  clear ();
+  nodes = nlist->length () - 1;
+  termStart.push_back (0);
+  for (int r = -1; r < nodes; r++) {
+    struct nodelist_t * n = nlist->getNode (r);
+    for (auto &t : *n) {
+      int c = addCircuit (t->getCircuit ());
+      portNode[portStart[c] + t->getPort ()] = r;
+      termCircuit.push_back (c);
+      termPort.push_back (t->getPort ());
+    }
+    termStart.push_back ((int) termCircuit.size ());
+  }
+}
+
+/* The function creates the topology of the given circuits using the
+   node numbers previously assigned to their nodes, with zero denoting
+   the ground node. */
+void topology::create (ptrlist<circuit> & list) {
+  clear ();
+  for (auto * c : list) {
+    int i = addCircuit (c);
+    for (int p = 0; p < c->getSize (); p++) {
+      int n = c->getNode (p)->getNode () - 1;
+      portNode[portStart[i] + p] = n;
+      if (n >= nodes) nodes = n + 1;
+    }
+  }
+  createTerminals ();
+}
+
+/* This function sorts the circuit ports by their nodes into the
+   terminal arrays.  The terminals of each node keep the order of the
+   circuits and ports. */
+void topology::createTerminals (void) {
+  int ports = (int) portNode.size ();
+  termStart.assign (nodes + 2, 0);
+  for (int p = 0; p < ports; p++) termStart[portNode[p] + 2]++;
+  for (int n = 0; n < nodes + 1; n++) termStart[n + 1] += termStart[n];
+  termCircuit.resize (ports);
+  termPort.resize (ports);
+  std::vector<int> fill (termStart.begin (), termStart.end () - 1);
+  for (int c = 0; c < getCircuits (); c++) {
+    for (int p = portStart[c]; p < portStart[c + 1]; p++) {
+      int t = fill[portNode[p] + 1]++;
+      termCircuit[t] = c;
+      termPort[t] = p - portStart[c];
+    }
+  }
+}
+
+} // namespace qucs
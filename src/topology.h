@@ -0,0 +1,87 @@
+/*
+ * topology.h - topology class definitions
+ *
+ * Copyright (C) 2026 Qucs Team
+ *
+ * This is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2, or (at your option)
+ * any later version.
+ *
+ * This software is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this package; see the file COPYING.  If not, write to
+ * the Free Software Foundation, Inc., 51 Franklin Street - Fifth Floor,
+ * Boston, MA 02110-1301, USA.
+ *
+ */
+
+
+#ifndef __TOPOLOGY_H__
+#define __TOPOLOGY_H__
+
+#include <vector>
+#include <unordered_map>
+
+#include "ptrlist.h"
+
+namespace qucs {
+
+class circuit;
+class nodelist;
+
+/* The topology class is a compact, index based view of the netlist
+   as seen by an analysis.  It is created once the nodes have been
+   enumerated and holds flat arrays of the circuits, the node index of
+   each circuit port and the terminals (circuit and port) connected to
+   each node.  Nodes are numbered from zero, the ground node is -1.
+   The view does not follow later changes of the netlist, thus the
+   S-parameter reduction joining circuits keeps its sorted node list. */
+class topology
+{
+ public:
+  topology ();
+  ~topology ();
+  void clear (void);
+  void create (nodelist *);
+  void create (ptrlist<circuit> &);
+  int getCircuits (void) const { return (int) circuits.size (); }
+  circuit * getCircuit (int c) const { return circuits[c]; }
+  int getIndex (circuit *) const;
+  int getNodes (void) const { return nodes; }
+  int getNode (int c, int port) const {
+    return portNode[portStart[c] + port];
+  }
+  int getPorts (int c) const { return portStart[c + 1] - portStart[c]; }
+  int getVoltageSource (int c) const { return vsource[c]; }
+  int getFirstTerminal (int n) const { return termStart[n + 1]; }
+  int getLastTerminal (int n) const { return termStart[n + 2]; }
+  circuit * getTerminalCircuit (int t) const {
+    return circuits[termCircuit[t]];
+  }
+  int getTerminalIndex (int t) const { return termCircuit[t]; }
+  int getTerminalPort (int t) const { return termPort[t]; }
+
+ private:
+  int addCircuit (circuit *);
+  void createTerminals (void);
+
+ private:
+  int nodes;
+  std::vector<circuit *> circuits;
+  std::unordered_map<circuit *, int> index;
+  std::vector<int> portStart;
+  std::vector<int> portNode;
+  std::vector<int> vsource;
+  std::vector<int> termStart;
+  std::vector<int> termCircuit;
+  std::vector<int> termPort;
+};
+
+} // namespace qucs
+
+#endif /* __TOPOLOGY_H__ */
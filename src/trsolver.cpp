@@ -49,6 +49,7 @@
 
 #define STEPDEBUG   0 // set to zero for release
 #define BREAKPOINTS 0 // exact breakpoint calculation
+#define CHORD_STEP  0.2 // largest step size change reusing the Jacobian
 
 #define dState 0 // delta T state
 #define sState 1 // solution state
@@ -71,6 +72,7 @@ trsolver::trsolver ()
     tHistory = NULL;
     relaxTSR = false;
     initialDC = true;
+    linearCoeff = 0;
 }
 
 // Constructor creates a named instance of the trsolver class.
@@ -84,6 +86,7 @@ trsolver::trsolver (const std::string &n)
     tHistory = NULL;
     relaxTSR = false;
     initialDC = true;
+    linearCoeff = 0;
 }
 
 // Destructor deletes the trsolver class object.
@@ -110,6 +113,7 @@ trsolver::trsolver (trsolver & o)
     tHistory = o.tHistory ? new history (*o.tHistory) : NULL;
     relaxTSR = o.relaxTSR;
     initialDC = o.initialDC;
+    linearCoeff = 0;
 }
 
 // This function creates the time sweep if necessary.
@@ -129,7 +133,7 @@ int trsolver::dcAnalysis (void)
     initDC ();
     setCalculation ((calculate_func_t) &calcDC);
     solve_pre ();
-    applyNodeset ();
+    applyStartingValues ();
 
     // Run the DC solver once.
     try_running ()
@@ -178,6 +182,11 @@ int trsolver::solve (void)
     const char * const solver = getPropertyString ("Solver");
     relaxTSR = !strcmp (getPropertyString ("relaxTSR"), "yes") ? true : false;
     initialDC = !strcmp (getPropertyString ("initialDC"), "yes") ? true : false;
+    bypass = !strcmp (getPropertyString ("Bypass"), "yes") ? 1 : 0;
+    threads = getPropertyInteger ("Threads");
+    int modified =
+        !strcmp (getPropertyString ("ModifiedNewton"), "yes") ? 1 : 0;
+    chord = 0;
 
     runs++;
     saveCurrent = current = 0;
@@ -185,6 +194,12 @@ int trsolver::solve (void)
     converged = 0;
     fixpoint = 0;
     statRejected = statSteps = statIterations = statConvergence = 0;
+    statBreakpoints = statMissed = 0;
+    chordDelta = 0;
+    chordOrder = 0;
+    chordValid = 0;
+    statFactored = statReused = 0;
+    statBypassed = statEvaluated = 0;
 
     // Choose a solver.
     if (!strcmp (solver, "CroutLU"))
@@ -197,6 +212,8 @@ int trsolver::solve (void)
         eqnAlgo = ALGO_QR_DECOMPOSITION_LS;
     else if (!strcmp (solver, "GolubSVD"))
         eqnAlgo = ALGO_SV_DECOMPOSITION;
+    else if (!strcmp (solver, "SparseLU"))
+        eqnAlgo = ALGO_LU_DECOMPOSITION_SPARSE;
 
     // Perform initial DC analysis.
     if (initialDC)
@@ -208,6 +225,7 @@ int trsolver::solve (void)
 
     // Initialize transient analysis.
     setDescription ("transient");
+    chord = modified; // modified Newton-Raphson for the time steps only
     initTR ();
     setCalculation ((calculate_func_t) &calcTR);
     solve_pre ();
@@ -226,6 +244,9 @@ int trsolver::solve (void)
     // Tell integrators to be initialized.
     setMode (MODE_INIT);
 
+    // Collect the first breakpoint of each source.
+    initBreakpoints ();
+
     int running = 0;
     rejected = 0;
     delta /= 10;
@@ -325,7 +346,7 @@ int trsolver::solve (void)
             if (rejected) continue;
 
             // check whether Jacobian matrix is still non-singular
-            if (!A->isFinite ())
+            if (As != NULL ? !As->isFinite () : !A->isFinite ())
             {
                 logprint (LOG_ERROR, "ERROR: %s: Jacobian singular at t = %.3e, "
                           "aborting %s analysis\n", getName (), (double) current,
@@ -340,7 +361,7 @@ int trsolver::solve (void)
             // Now advance in time or not...
             if (running > 1)
             {
-                adjustDelta (time);
+                adjustDelta (nextBreakpoint (time));
                 adjustOrder ();
             }
             else
@@ -350,6 +371,16 @@ int trsolver::solve (void)
                 rejected = 0;
             }
 
+            // Restart the integration at low order and with a small step
+            // once a source breakpoint has been reached.
+            if (!rejected && passBreakpoints (current))
+            {
+                adjustOrder (1);
+                stepDelta = -1.0;
+                nr_double_t next = nextBreakpoint (current + delta) - current;
+                delta = std::max (0.1 * next, deltaMin);
+            }
+
             saveCurrent = current;
             current += delta;
             running++;
@@ -387,9 +418,18 @@ int trsolver::solve (void)
     if (progress) logprogressclear (40);
     logprint (LOG_STATUS, "NOTIFY: %s: average time-step %g, %d rejections\n",
               getName (), (double) (saveCurrent / statSteps), statRejected);
+    logprint (LOG_STATUS, "NOTIFY: %s: %d source breakpoints, %d missed\n",
+              getName (), statBreakpoints, statMissed);
     logprint (LOG_STATUS, "NOTIFY: %s: average NR-iterations %g, "
               "%d non-convergences\n", getName (),
               (double) statIterations / statSteps, statConvergence);
+    logprint (LOG_STATUS, "NOTIFY: %s: %d of %d device evaluations "
+              "bypassed\n", getName (), statBypassed,
+              statBypassed + statEvaluated);
+    if (chord)
+        logprint (LOG_STATUS, "NOTIFY: %s: %d of %d Jacobian factorizations "
+                  "avoided\n", getName (), statReused,
+                  statReused + statFactored);
 
     // cleanup
     deinitTR ();
@@ -569,6 +609,22 @@ void trsolver::predictGear (void)
 int trsolver::corrector (void)
 {
     int error = 0;
+    /* The Jacobian depends on the step size and the integration order,
+       thus refactorize it in modified Newton-Raphson if they changed. */
+    if (chord && (!chordValid || corrOrder != chordOrder ||
+                  fabs (delta - chordDelta) > CHORD_STEP * chordDelta))
+    {
+        chordValid = 0;
+        chordDelta = delta;
+        chordOrder = corrOrder;
+    }
+    /* The linear part of the MNA matrix depends on the leading corrector
+       coefficient only, keep it as long as this does not change. */
+    if (corrCoeff[0] != linearCoeff)
+    {
+        linearValid = 0;
+        linearCoeff = corrCoeff[0];
+    }
     error += solve_nonlinear ();
     return error;
 }
@@ -631,7 +687,10 @@ void trsolver::adjustDelta (nr_double_t t)
     int good = 0;
     if (!relaxTSR)   // relaxed step raster?
     {
-        if (!statConvergence || converged > 64)   /* Is this a good guess? */
+        // source breakpoints are always hit, requested time points
+        // only after a number of converged steps
+        bool source = !breakpoints.empty () && breakpoints.begin()->first == t;
+        if (source || !statConvergence || converged > 64)   /* Is this a good guess? */
         {
             // check next breakpoint
             if (stepDelta > 0.0)
@@ -702,6 +761,57 @@ void trsolver::adjustDelta (nr_double_t t)
     }
 }
 
+/* Goes through the list of circuit objects and collects the first
+   breakpoint of each time dependent source into the breakpoint
+   queue. */
+void trsolver::initBreakpoints (void)
+{
+    breakpoints.clear ();
+    circuit * root = subnet->getRoot ();
+    for (circuit * c = root; c != NULL; c = (circuit *) c->getNext ())
+    {
+        nr_double_t t = c->nextBreakpoint (current);
+        if (t > current)
+            breakpoints.insert (std::make_pair (t, c));
+    }
+}
+
+/* Returns the earliest source breakpoint before the given time or the
+   given time itself if there is none. */
+nr_double_t trsolver::nextBreakpoint (nr_double_t t)
+{
+    if (breakpoints.empty () || breakpoints.begin()->first >= t)
+        return t;
+    return breakpoints.begin()->first;
+}
+
+/* The function removes the breakpoints reached at the given time from
+   the queue and inserts the following breakpoint of each affected
+   source instead.  Breakpoints closer than the minimum step size or
+   the rounding error of the time are considered reached, earlier ones
+   are counted as missed.  It returns the number of reached or passed
+   breakpoints. */
+int trsolver::passBreakpoints (nr_double_t t)
+{
+    nr_double_t tol = std::max (deltaMin, 4 * DBL_EPSILON * t);
+    int passed = 0;
+    while (!breakpoints.empty () &&
+           breakpoints.begin()->first <= t + tol)
+    {
+        circuit * c = breakpoints.begin()->second;
+        if (breakpoints.begin()->first < t - tol) statMissed++;
+        breakpoints.erase (breakpoints.begin ());
+        nr_double_t next = c->nextBreakpoint (t);
+        while (next > 0 && next <= t + tol)
+            next = c->nextBreakpoint (next);
+        if (next > 0)
+            breakpoints.insert (std::make_pair (next, c));
+        passed++;
+    }
+    statBreakpoints += passed;
+    return passed;
+}
+
 /* The function can be used to increase the current order of the
    integration method or to reduce it. */
 void trsolver::adjustOrder (int reduce)
@@ -732,25 +842,29 @@ void trsolver::adjustOrder (int reduce)
 }
 
 /* Goes through the list of circuit objects and runs its calcDC()
-   function. */
+   function unless the evaluation of the circuit can be bypassed. */
 void trsolver::calcDC (trsolver * self)
 {
-    circuit * root = self->getNet()->getRoot ();
-    for (circuit * c = root; c != NULL; c = (circuit *) c->getNext ())
-    {
-        c->calcDC ();
-    }
+    self->evaluate ((evaluate_func_t) &calcCircuitDC);
+}
+
+// Runs the calcDC() function of the given circuit.
+void trsolver::calcCircuitDC (circuit * c, trsolver *)
+{
+    c->calcDC ();
 }
 
 /* Goes through the list of circuit objects and runs its calcTR()
-   function. */
+   function unless the evaluation of the circuit can be bypassed. */
 void trsolver::calcTR (trsolver * self)
 {
-    circuit * root = self->getNet()->getRoot ();
-    for (circuit * c = root; c != NULL; c = (circuit *) c->getNext ())
-    {
-        c->calcTR (self->current);
-    }
+    self->evaluate ((evaluate_func_t) &calcCircuitTR);
+}
+
+// Runs the calcTR() function of the given circuit.
+void trsolver::calcCircuitTR (circuit * c, trsolver * self)
+{
+    c->calcTR (self->current);
 }
 
 /* Goes through the list of circuit objects and runs its initDC()
@@ -760,6 +874,7 @@ void trsolver::initDC (void)
     circuit * root = subnet->getRoot ();
     for (circuit * c = root; c != NULL; c = (circuit *) c->getNext ())
     {
+        c->setRealMNA (true);
         c->initDC ();
     }
 }
@@ -843,11 +958,13 @@ void trsolver::deinitTR (void)
         delete tHistory;
         tHistory = NULL;
     }
+    breakpoints.clear ();
 }
 
 // The function initialize a single circuit.
 void trsolver::initCircuitTR (circuit * c)
 {
+    c->setRealMNA (true);
     c->initTR ();
     c->initStates ();
     c->setCoefficients (corrCoeff);
@@ -959,6 +1076,9 @@ PROP_OPT [] =
     { "Solver", PROP_STR, { PROP_NO_VAL, "CroutLU" }, PROP_RNG_SOL },
     { "relaxTSR", PROP_STR, { PROP_NO_VAL, "no" }, PROP_RNG_YESNO },
     { "initialDC", PROP_STR, { PROP_NO_VAL, "yes" }, PROP_RNG_YESNO },
+    { "Bypass", PROP_STR, { PROP_NO_VAL, "no" }, PROP_RNG_YESNO },
+    { "ModifiedNewton", PROP_STR, { PROP_NO_VAL, "no" }, PROP_RNG_YESNO },
+    { "Threads", PROP_INT, { 1, PROP_NO_STR }, PROP_MIN_VAL (1) },
     PROP_NO_PROP
 };
 struct define_t trsolver::anadef =
@@ -25,6 +25,8 @@
 #ifndef __TRSOLVER_H__
 #define __TRSOLVER_H__
 
+#include <map>
+
 #include "nasolver.h"
 #include "states.h"
 
@@ -53,8 +55,10 @@ public:
     void initTR (void);
     void deinitTR (void);
     static void calcTR (trsolver *);
+    static void calcCircuitTR (circuit *, trsolver *);
     void initDC (void);
     static void calcDC (trsolver *);
+    static void calcCircuitDC (circuit *, trsolver *);
     void initSteps (void);
     void saveAllResults (nr_double_t);
     nr_double_t checkDelta (void);
@@ -68,6 +72,15 @@ public:
     void initCircuitTR (circuit *);
     void fillSolution (tvector<nr_double_t> *);
     int  dcAnalysis (void);
+    void initBreakpoints (void);
+    nr_double_t nextBreakpoint (nr_double_t);
+    int  passBreakpoints (nr_double_t);
+    /// Returns the number of rejected time steps.
+    int getRejected (void) { return statRejected; }
+    /// Returns the number of reached source breakpoints.
+    int getBreakpoints (void) { return statBreakpoints; }
+    /// Returns the number of source breakpoints stepped over.
+    int getMissed (void) { return statMissed; }
 
 protected:
     sweep * swp;
@@ -79,6 +92,8 @@ protected:
     nr_double_t deltaMin;
     nr_double_t deltaOld;
     nr_double_t stepDelta;
+    nr_double_t chordDelta; // step size of the reused Jacobian
+    nr_double_t linearCoeff; // corrector coefficient of the linear matrix
     int CMethod;      // user specified corrector method
     int PMethod;      // user specified predictor method
     int corrMaxOrder; // maximum corrector order
@@ -87,15 +102,18 @@ protected:
     int predType;     // current predictor method
     int corrOrder;    // current corrector order
     int predOrder;    // current predictor order
+    int chordOrder;   // corrector order of the reused Jacobian
     int rejected;
     int converged;
     tvector<nr_double_t> * solution[8];
     nr_double_t current;
     int statSteps;
     int statRejected;
-    int statIterations;
     int statConvergence;
+    int statBreakpoints;
+    int statMissed;
     history * tHistory;
+    std::multimap<nr_double_t, circuit *> breakpoints;
     bool relaxTSR;
     bool initialDC;
     int ohm;
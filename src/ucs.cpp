@@ -66,6 +66,7 @@ int main (int argc, char ** argv) {
   dataset * out;
   environment * root;
   int listing = 0;
+  int binary = 0;
   int ret = 0;
   int dynamicLoad = 0;
 
@@ -100,6 +101,7 @@ int main (int argc, char ** argv) {
 	"  -v, --version  display version information and exit\n"
 	"  -i FILENAME    use file as input netlist (default stdin)\n"
 	"  -o FILENAME    use file as output dataset (default stdout)\n"
+	"  -B, --binary   write the output dataset in binary format\n"
 	"  -b, --bar      enable textual progress bar\n"
 	"  -g, --gui      special progress bar used by gui\n"
 	"  -c, --check    check the input netlist and exit\n"
@@ -118,6 +120,9 @@ int main (int argc, char ** argv) {
       outfile = argv[++i];
       redirect_status_to_stdout();
     }
+    else if (!strcmp (argv[i], "-B") || !strcmp (argv[i], "--binary")) {
+      binary = 1;
+    }
     else if (!strcmp (argv[i], "-b") || !strcmp (argv[i], "--bar")) {
       progressbar_enable = 1;
     }
@@ -254,14 +259,17 @@ int main (int argc, char ** argv) {
   // evaluate output dataset
   ret |= root->equationSolver (out);
   out->setFile (outfile);
-  out->print ();
+  if (binary)
+    out->printBinary ();
+  else
+    out->print ();
 
   estack.print ("uncaught");
 
   delete subnet;
-  delete in;
   delete out;
   delete root;
+  delete in;
 
   // delete static modules and dynamic modules
   module::unregisterModules ();
@@ -269,6 +277,5 @@ int main (int argc, char ** argv) {
   // close all the dynamic libs if any opened
   module::closeDynamicLibs();
 
-  netlist_destroy_env ();
   return ret;
 }
@@ -0,0 +1,152 @@
+/*
+ * DCSolver.cpp - Unit test for the DC solver
+ *
+ * Copyright (C) 2026 Qucs Team
+ *
+ * This is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2, or (at your option)
+ * any later version.
+ *
+ * This software is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this package; see the file COPYING.  If not, write to
+ * the Free Software Foundation, Inc., 51 Franklin Street - Fifth Floor,
+ * Boston, MA 02110-1301, USA.
+ *
+ */
+
+#include <stdio.h>
+#include <string>
+#include <vector>
+
+#include "testNetlist.h"  // netlists loaded from memory
+#include "nasolver.h"
+#include "dcsolver.h"
+#include "gtest/gtest.h"  // Google Test
+
+static const char * diodesweep =
+  "Vdc:V1 in gnd U=\"Vin\"\n"
+  "R:R1 in a R=\"100 Ohm\" Temp=\"26.85\" Tc1=\"0.0\" Tc2=\"0.0\" "
+  "Tnom=\"26.85\"\n"
+  "Diode:D1 gnd a Is=\"1e-14\" N=\"1\" Cj0=\"1 pF\" M=\"0.5\" Vj=\"0.7\"\n"
+  ".DC:DC1 Solver=\"CroutLU\" Bypass=\"%s\" MaxIter=\"%d\"\n"
+  ".SW:SW1 Sim=\"DC1\" Type=\"lin\" Param=\"Vin\" Start=\"0\" Stop=\"%d\" "
+  "Points=\"%d\" Continuation=\"%s\"\n";
+
+// Returns the DC analysis of the given diode sweep.
+static qucs::dcsolver * sweepSolver (memnet & n) {
+  qucs::analysis * sw = n.subnet->findAnalysis ("SW1");
+  return dynamic_cast<qucs::dcsolver *> (sw->getAnalysis ()->front ());
+}
+
+TEST (parasweep, continuation) {
+  netsetup s;
+  memnet n1 (format (diodesweep, "no", 150, 5, 51, "no"));
+  memnet n2 (format (diodesweep, "no", 150, 5, 51, "yes"));
+  ASSERT_TRUE (n1.loaded && n1.run () != NULL);
+  ASSERT_TRUE (n2.loaded && n2.run () != NULL);
+  qucs::vector v1 = n1.result ("a.V");
+  qucs::vector v2 = n2.result ("a.V");
+  ASSERT_EQ (51, v1.getSize ());
+  ASSERT_EQ (51, v2.getSize ());
+  for (int i = 0; i < 51; i++)
+    EXPECT_NEAR (real (v1.get (i)), real (v2.get (i)), 1e-6);
+  EXPECT_LT (sweepSolver (n2)->getIterations (),
+	     sweepSolver (n1)->getIterations ());
+
+  // large steps exceeding the iteration limit are subdivided
+  memnet r (format (diodesweep, "no", 150, 100, 3, "no"));
+  memnet n3 (format (diodesweep, "no", 6, 100, 3, "no"));
+  memnet n4 (format (diodesweep, "no", 6, 100, 3, "yes"));
+  ASSERT_TRUE (r.loaded && r.run () != NULL);
+  ASSERT_TRUE (n3.loaded && n3.run () != NULL);
+  ASSERT_TRUE (n4.loaded && n4.run () != NULL);
+  qucs::vector vr = r.result ("a.V");
+  qucs::vector v4 = n4.result ("a.V");
+  ASSERT_EQ (3, vr.getSize ());
+  ASSERT_EQ (3, v4.getSize ());
+  for (int i = 0; i < 3; i++)
+    EXPECT_NEAR (real (vr.get (i)), real (v4.get (i)), 1e-6);
+  EXPECT_GT (sweepSolver (n4)->getSubdivided (), 0);
+  EXPECT_EQ (0, sweepSolver (n3)->getSubdivided ());
+  EXPECT_LT (sweepSolver (n4)->getIterations (),
+	     sweepSolver (n3)->getIterations ());
+}
+
+/* With three iterations the subdivision runs out of steps before it
+   reaches the sweep points.  These points are left to the convergence
+   helpers as without continuation, the last intermediate solution must
+   not be stored in their place. */
+TEST (parasweep, subdivision) {
+  netsetup s;
+  memnet n1 (format (diodesweep, "no", 3, 10, 3, "no"));
+  memnet n2 (format (diodesweep, "no", 3, 10, 3, "yes"));
+  ASSERT_TRUE (n1.loaded && n1.run () != NULL);
+  ASSERT_TRUE (n2.loaded && n2.run () != NULL);
+  qucs::vector v1 = n1.result ("a.V");
+  qucs::vector v2 = n2.result ("a.V");
+  ASSERT_EQ (3, v1.getSize ());
+  ASSERT_EQ (3, v2.getSize ());
+  for (int i = 0; i < 3; i++)
+    EXPECT_NEAR (real (v1.get (i)), real (v2.get (i)), 1e-6) << i;
+  EXPECT_GT (sweepSolver (n2)->getSubdivided (), 0);
+}
+
+TEST (dcsolver, bypass) {
+  netsetup s;
+  memnet n1 (format (diodesweep, "no", 150, 5, 51, "no"));
+  memnet n2 (format (diodesweep, "yes", 150, 5, 51, "no"));
+  ASSERT_TRUE (n1.loaded && n1.run () != NULL);
+  ASSERT_TRUE (n2.loaded && n2.run () != NULL);
+  qucs::vector v1 = n1.result ("a.V");
+  qucs::vector v2 = n2.result ("a.V");
+  ASSERT_EQ (51, v1.getSize ());
+  ASSERT_EQ (51, v2.getSize ());
+  for (int i = 0; i < 51; i++)
+    EXPECT_NEAR (real (v1.get (i)), real (v2.get (i)), 1e-6);
+  EXPECT_EQ (0, sweepSolver (n1)->getBypassed ());
+  EXPECT_GT (sweepSolver (n2)->getBypassed (), 0);
+}
+
+// Solves a diode ladder using the given number of threads.
+static std::vector<nr_double_t> solveDiodeLadder (int threads) {
+  const int nodes = 80;
+  char buf[256];
+  std::string net = "Vdc:V1 n0 gnd U=\"10 V\"\n";
+  for (int k = 1; k <= nodes; k++) {
+    snprintf (buf, sizeof (buf), "R:R%d n%d n%d R=\"%d Ohm\" Temp=\"26.85\" "
+	      "Tc1=\"0.0\" Tc2=\"0.0\" Tnom=\"26.85\"\n", k, k - 1, k, 10 + k);
+    net += buf;
+    snprintf (buf, sizeof (buf), "Diode:D%d gnd n%d Is=\"1e-14\" N=\"1\" "
+	      "Cj0=\"1 pF\" M=\"0.5\" Vj=\"0.7\"\n", k, k);
+    net += buf;
+  }
+  snprintf (buf, sizeof (buf), ".DC:DC1 Solver=\"CroutLU\" Threads=\"%d\"\n",
+	    threads);
+  net += buf;
+
+  memnet n (net);
+  std::vector<nr_double_t> v;
+  if (n.loaded && n.run () != NULL) {
+    for (int k = 1; k <= nodes; k++) {
+      snprintf (buf, sizeof (buf), "n%d.V", k);
+      if (n.result (buf).getSize () > 0) v.push_back (n.value (buf));
+    }
+  }
+  return v;
+}
+
+TEST (dcsolver, threads) {
+  netsetup s;
+  std::vector<nr_double_t> v1 = solveDiodeLadder (1);
+  std::vector<nr_double_t> v4 = solveDiodeLadder (4);
+  ASSERT_EQ (80u, v1.size ());
+  ASSERT_EQ (80u, v4.size ());
+  for (int i = 0; i < 80; i++)
+    EXPECT_EQ (v1[i], v4[i]);
+}
@@ -0,0 +1,94 @@
+/*
+ * Dataset.cpp - Unit test for the binary dataset format
+ *
+ * Copyright (C) 2026 Qucs Team
+ *
+ * This is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2, or (at your option)
+ * any later version.
+ *
+ * This software is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this package; see the file COPYING.  If not, write to
+ * the Free Software Foundation, Inc., 51 Franklin Street - Fifth Floor,
+ * Boston, MA 02110-1301, USA.
+ *
+ */
+
+#include <stdio.h>
+#include <stdint.h>
+
+#include "qucs_typedefs.h"
+#include "complex.h"
+#include "object.h"
+#include "strlist.h"
+#include "vector.h"
+#include "dataset.h"
+
+#include "gtest/gtest.h"  // Google Test
+
+TEST (dataset, binary) {
+  const char * file = "dataset_binary.dat";
+  qucs::dataset * data = new qucs::dataset ();
+  qucs::vector * f = new qucs::vector ("frequency", 3);
+  qucs::vector * s = new qucs::vector ("S", 3);
+  qucs::vector * p = new qucs::vector ("Pin", 1);
+  qucs::strlist * deps = new qucs::strlist ();
+  deps->add ("frequency");
+  s->setDependencies (deps);
+  for (int i = 0; i < 3; i++) {
+    f->set (1e9 * (i + 1), i);
+    s->set (nr_complex_t (0.1 * i, -0.3 / (i + 1)), i);
+  }
+  p->set (-7.5, 0);
+  data->appendDependency (f);
+  data->appendVariable (s);
+  data->appendVariable (p);
+  data->setFile (file);
+  data->printBinary ();
+
+  qucs::dataset * res = qucs::dataset::load (file);
+  ASSERT_TRUE (res != NULL);
+  qucs::vector * g = res->findDependency ("frequency");
+  qucs::vector * t = res->findVariable ("S");
+  ASSERT_TRUE (g != NULL && t != NULL);
+  ASSERT_TRUE (res->findDependency ("Pin") != NULL);
+  EXPECT_EQ (3, t->getSize ());
+  EXPECT_STREQ ("frequency", t->getDependencies ()->get (0));
+  for (int i = 0; i < 3; i++) {
+    EXPECT_EQ (f->get (i), g->get (i));
+    EXPECT_EQ (s->get (i), t->get (i));
+  }
+  EXPECT_EQ (-7.5, real (res->findDependency ("Pin")->get (0)));
+  delete res;
+  delete data;
+  remove (file);
+}
+
+/* A corrupt number of values in a record header must not allocate the
+   vector, the dataset is rejected. */
+TEST (dataset, binary_corrupt) {
+  const char * file = "dataset_corrupt.dat";
+  qucs::dataset * data = new qucs::dataset ();
+  qucs::vector * f = new qucs::vector ("frequency", 3);
+  for (int i = 0; i < 3; i++) f->set (1e9 * (i + 1), i);
+  data->appendDependency (f);
+  data->setFile (file);
+  data->printBinary ();
+  delete data;
+
+  // the value count follows the flags of the first record
+  FILE * fp = fopen (file, "r+b");
+  ASSERT_TRUE (fp != NULL);
+  uint32_t n = 0xffffffff;
+  fseek (fp, 8 + 2 * sizeof (uint32_t) + sizeof (uint32_t), SEEK_SET);
+  fwrite (&n, sizeof (uint32_t), 1, fp);
+  fclose (fp);
+  EXPECT_TRUE (qucs::dataset::load (file) == NULL);
+  remove (file);
+}
@@ -20,7 +20,10 @@
  *
  */
 
+#include <cmath>
+
 #include "qucs_typedefs.h"
+#include "consts.h"
 #include "object.h"
 #include "vector.h"
 #include "fourier.h"
@@ -44,3 +47,49 @@ TEST (fourier, fft) {
     else
       EXPECT_EQ ( 0 , vdif.get(k).real() );
 }
+
+TEST (fourier, mixed_radix) {
+  // fft of lengths other than powers of two against the plain dft,
+  // 60 = 4 * 3 * 5 and the prime 97
+  int lens[] = { 60, 97 };
+  for (int l = 0; l < 2; l++) {
+    int n = lens[l];
+    nr_double_t * a = new nr_double_t[2 * n];
+    nr_double_t * b = new nr_double_t[2 * n];
+    for (int k = 0; k < 2 * n; k++)
+      a[k] = b[k] = std::cos (0.3 * k * k + 1.0);
+
+    qucs::fourier::_fft_1d (a, n, 1);
+    qucs::fourier::_dft_1d (b, n, 1);
+    for (int k = 0; k < 2 * n; k++)
+      EXPECT_NEAR ( b[k], a[k], 1e-10 );
+
+    qucs::fourier::_ifft_1d (a, n);
+    qucs::fourier::_idft_1d (b, n);
+    for (int k = 0; k < 2 * n; k++)
+      EXPECT_NEAR ( b[k], a[k], 1e-10 );
+
+    delete[] a;
+    delete[] b;
+  }
+}
+
+TEST (fourier, real) {
+  // real valued fft of a cosine and back
+  // in   [2, 0, -2, 0, 2, 0, -2, 0]
+  // out  [0, 0, 8, 0, 0]
+  int n = 8;
+  nr_double_t d[10];
+  for (int k = 0; k < n; k++)
+    d[k] = 2 * std::cos (qucs::pi * k / 2);
+
+  qucs::fourier::_rfft_1d (d, n);
+  for (int k = 0; k <= n / 2; k++) {
+    EXPECT_NEAR ( k == 2 ? 8 : 0, d[2 * k], 1e-12 );
+    EXPECT_NEAR ( 0, d[2 * k + 1], 1e-12 );
+  }
+
+  qucs::fourier::_irfft_1d (d, n);
+  for (int k = 0; k < n; k++)
+    EXPECT_NEAR ( 2 * std::cos (qucs::pi * k / 2), d[k] / n, 1e-12 );
+}
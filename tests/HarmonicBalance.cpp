@@ -0,0 +1,71 @@
+/*
+ * HarmonicBalance.cpp - Unit test for the harmonic balance solver
+ *
+ * Copyright (C) 2026 Qucs Team
+ *
+ * This is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2, or (at your option)
+ * any later version.
+ *
+ * This software is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this package; see the file COPYING.  If not, write to
+ * the Free Software Foundation, Inc., 51 Franklin Street - Fifth Floor,
+ * Boston, MA 02110-1301, USA.
+ *
+ */
+
+#include <stdio.h>
+#include <string>
+#include <vector>
+#include "testNetlist.h"  // netlists loaded from memory
+#include "gtest/gtest.h"  // Google Test
+
+// Solves a diode ladder by the HB analysis using the given number of threads.
+static std::vector<nr_complex_t> solveHBLadder (int threads) {
+  const int nodes = 8;
+  char buf[256];
+  std::string net = "Vac:V1 n0 gnd U=\"2 V\" f=\"1 GHz\" Phase=\"0\" "
+    "Theta=\"0\"\n";
+  for (int k = 1; k <= nodes; k++) {
+    snprintf (buf, sizeof (buf), "R:R%d n%d n%d R=\"%d Ohm\" Temp=\"26.85\" "
+	      "Tc1=\"0.0\" Tc2=\"0.0\" Tnom=\"26.85\"\n", k, k - 1, k, 10 + k);
+    net += buf;
+    snprintf (buf, sizeof (buf), "Diode:D%d n%d gnd Is=\"1e-14\" N=\"1\" "
+	      "Cj0=\"1 pF\" M=\"0.5\" Vj=\"0.7\"\n", k, k);
+    net += buf;
+    snprintf (buf, sizeof (buf), "C:C%d n%d gnd C=\"0.5 pF\"\n", k, k);
+    net += buf;
+  }
+  snprintf (buf, sizeof (buf), ".HB:HB1 f=\"1 GHz\" n=\"4\" Threads=\"%d\"\n",
+	    threads);
+  net += buf;
+
+  memnet n (net);
+  std::vector<nr_complex_t> v;
+  if (n.loaded && n.run () != NULL) {
+    for (int k = 1; k <= nodes; k++) {
+      snprintf (buf, sizeof (buf), "n%d.Vb", k);
+      qucs::vector r = n.result (buf);
+      for (int i = 0; i < r.getSize (); i++) v.push_back (r.get (i));
+    }
+  }
+  return v;
+}
+
+TEST (hbsolver, threads) {
+  netsetup s;
+  std::vector<nr_complex_t> v1 = solveHBLadder (1);
+  std::vector<nr_complex_t> v4 = solveHBLadder (4);
+  ASSERT_EQ (8u * 5, v1.size ());
+  ASSERT_EQ (v1.size (), v4.size ());
+  for (unsigned int i = 0; i < v1.size (); i++) {
+    EXPECT_EQ (real (v1[i]), real (v4[i]));
+    EXPECT_EQ (imag (v1[i]), imag (v4[i]));
+  }
+}
@@ -0,0 +1,162 @@
+/*
+ * Netlist.cpp - Unit test for loading netlists from memory
+ *
+ * Copyright (C) 2026 Qucs Team
+ *
+ * This is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2, or (at your option)
+ * any later version.
+ *
+ * This software is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this package; see the file COPYING.  If not, write to
+ * the Free Software Foundation, Inc., 51 Franklin Street - Fifth Floor,
+ * Boston, MA 02110-1301, USA.
+ *
+ */
+
+#include <string>
+#include <thread>
+
+#include "testNetlist.h"  // netlists loaded from memory
+#include "gtest/gtest.h"  // Google Test
+
+static const char * divider =
+  "Vdc:V1 in gnd U=\"1 V\"\n"
+  "R:R1 in out R=\"1 kOhm\" Temp=\"26.85\" Tc1=\"0.0\" Tc2=\"0.0\" "
+  "Tnom=\"26.85\"\n"
+  "R:R2 out gnd R=\"%s\" Temp=\"26.85\" Tc1=\"0.0\" Tc2=\"0.0\" "
+  "Tnom=\"26.85\"\n"
+  ".DC:DC1 Temp=\"26.85\" reltol=\"0.001\" abstol=\"1 pA\" "
+  "vntol=\"1 uV\" saveOPs=\"no\" MaxIter=\"150\" saveAll=\"no\" "
+  "convHelper=\"none\" Solver=\"CroutLU\"\n";
+
+// Loads the voltage divider with the given lower resistor from memory.
+static nr_double_t solveDivider (const char * r) {
+  memnet n (format (divider, r));
+  if (!n.loaded || n.run () == NULL) return -1;
+  return n.value ("out.V");
+}
+
+TEST (input, buffer) {
+  netsetup s;
+  EXPECT_NEAR (0.5, solveDivider ("1 kOhm"), 1e-9);
+  EXPECT_NEAR (0.75, solveDivider ("3 kOhm"), 1e-9);
+}
+
+/* The parser and checker keep their state in the netlist context of
+   each input object, thus different netlists can be loaded at the same
+   time. */
+TEST (input, threads) {
+  netsetup s;
+  for (int k = 0; k < 20; k++) {
+    memnet * n[2] = { NULL, NULL };
+    std::thread a ([&n] { n[0] = new memnet (format (divider, "1 kOhm")); });
+    std::thread b ([&n] { n[1] = new memnet (format (divider, "3 kOhm")); });
+    a.join ();
+    b.join ();
+    ASSERT_TRUE (n[0]->loaded);
+    ASSERT_TRUE (n[1]->loaded);
+    ASSERT_TRUE (n[0]->run () != NULL);
+    ASSERT_TRUE (n[1]->run () != NULL);
+    EXPECT_NEAR (0.5, n[0]->value ("out.V"), 1e-9);
+    EXPECT_NEAR (0.75, n[1]->value ("out.V"), 1e-9);
+    delete n[0];
+    delete n[1];
+  }
+}
+
+TEST (net, rerun) {
+  netsetup s;
+  memnet n (format (divider, "1 kOhm"));
+  ASSERT_TRUE (n.loaded);
+  ASSERT_TRUE (n.run () != NULL);
+  EXPECT_NEAR (0.5, n.value ("out.V"), 1e-9);
+
+  // modify the lower resistor and solve the DC analysis only
+  EXPECT_EQ (0, n.subnet->setProperty ("R2.R", 3e3));
+  EXPECT_NE (0, n.subnet->setProperty ("R2.X", 3e3));
+  EXPECT_NE (0, n.subnet->setProperty ("R3.R", 3e3));
+  ASSERT_TRUE (n.run ("DC1") != NULL);
+  EXPECT_EQ (0, n.err);
+  EXPECT_NEAR (0.75, n.value ("out.V"), 1e-9);
+  EXPECT_FALSE (n.subnet->findAnalysis ("DC1")->getWarmStart ());
+  EXPECT_TRUE (n.run ("AC1") == NULL);
+}
+
+static const char * nested =
+  ".Def:inner a b Rv=\"1k\" Rw=\"2k\"\n"
+  "R:R1 a m R=\"Rv\"\n"
+  "R:R2 m b R=\"Rw\"\n"
+  ".Def:End\n"
+  ".Def:outer x y Ro=\"500\"\n"
+  "Sub:XA x z Type=\"inner\" Rv=\"Ro\"\n"
+  "Sub:XB z y Type=\"inner\" Rw=\"Ro\"\n"
+  "R:Rz z gnd R=\"10k\"\n"
+  ".Def:End\n"
+  "Vdc:V1 n0 gnd U=\"1 V\"\n"
+  "Sub:X0 n0 n1 Type=\"outer\" Ro=\"100\"\n"
+  "Sub:X1 n1 gnd Type=\"inner\" Rv=\"50\"\n"
+  "Sub:X2 n1 gnd Type=\"outer\"\n"
+  ".DC:DC1 Solver=\"CroutLU\" saveAll=\"yes\"\n";
+
+// The same circuit with the subcircuits expanded by hand.
+static const char * flattened =
+  "Vdc:V1 n0 gnd U=\"1 V\"\n"
+  "R:A1 n0 a R=\"100\"\n"
+  "R:A2 a z R=\"2000\"\n"
+  "R:B1 z b R=\"1000\"\n"
+  "R:B2 b n1 R=\"100\"\n"
+  "R:Z z gnd R=\"10k\"\n"
+  "R:C1 n1 c R=\"50\"\n"
+  "R:C2 c gnd R=\"2000\"\n"
+  "R:D1 n1 d R=\"500\"\n"
+  "R:D2 d y R=\"2000\"\n"
+  "R:E1 y e R=\"1000\"\n"
+  "R:E2 e gnd R=\"500\"\n"
+  "R:Y y gnd R=\"10k\"\n"
+  ".DC:DC1 Solver=\"CroutLU\" saveAll=\"yes\"\n";
+
+// Counts the circuits of the given netlist.
+static int countCircuits (qucs::net * subnet) {
+  int n = 0;
+  for (qucs::circuit * c = subnet->getRoot (); c != NULL;
+       c = (qucs::circuit *) c->getNext ())
+    n++;
+  return n;
+}
+
+TEST (input, subcircuits) {
+  netsetup s;
+  memnet n (nested);
+  ASSERT_TRUE (n.loaded);
+
+  // only the top-level source exists before the first analysis
+  EXPECT_EQ (1, countCircuits (n.subnet));
+  ASSERT_TRUE (n.run () != NULL);
+  EXPECT_EQ (0, n.err);
+  EXPECT_EQ (1 + 5 + 2 + 5, countCircuits (n.subnet));
+
+  // parameters are passed through both levels of the hierarchy
+  const char * names[] = {
+    "inner.X0.XA.R1", "inner.X0.XA.R2", "inner.X0.XB.R1", "inner.X0.XB.R2",
+    "inner.X1.R1", "inner.X1.R2", "inner.X2.XA.R1", "inner.X2.XB.R2" };
+  const nr_double_t values[] = { 100, 2000, 1000, 100, 50, 2000, 500, 500 };
+  for (int i = 0; i < 8; i++) {
+    qucs::circuit * c = n.subnet->findCircuit (names[i]);
+    ASSERT_TRUE (c != NULL) << names[i];
+    EXPECT_DOUBLE_EQ (values[i], c->getPropertyDouble ("R")) << names[i];
+  }
+
+  // compare against the flat netlist
+  memnet f (flattened);
+  ASSERT_TRUE (f.loaded);
+  ASSERT_TRUE (f.run () != NULL);
+  EXPECT_NEAR (f.value ("n1.V"), n.value ("n1.V"), 1e-12);
+  EXPECT_NEAR (f.value ("z.V"), n.value ("outer.X0.z.V"), 1e-12);
+}
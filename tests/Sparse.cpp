@@ -0,0 +1,219 @@
+/*
+ * Sparse.cpp - Unit test for the sparse equation system solver
+ *
+ * Copyright (C) 2026 Qucs Team
+ *
+ * This is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2, or (at your option)
+ * any later version.
+ *
+ * This software is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this package; see the file COPYING.  If not, write to
+ * the Free Software Foundation, Inc., 51 Franklin Street - Fifth Floor,
+ * Boston, MA 02110-1301, USA.
+ *
+ */
+
+#include "qucs_typedefs.h"
+#include "real.h"
+#include "complex.h"
+#include "tvector.h"
+#include "tmatrix.h"
+#include "spmatrix.h"
+#include "eqnsys.h"
+
+#include "gtest/gtest.h"  // Google Test
+
+// Builds a resistive ladder with a voltage source branch (zero diagonal).
+static void ladder (int n, qucs::spmatrix<nr_double_t> & As,
+		    qucs::tmatrix<nr_double_t> & A) {
+  for (int i = 0; i < n; i++) {
+    As.insert (i, i);
+    if (i > 0) { As.insert (i, i - 1); As.insert (i - 1, i); }
+  }
+  As.insert (0, n); As.insert (n, 0); As.insert (n, n);
+  As.compress ();
+  for (int i = 0; i < n; i++) {
+    nr_double_t g = 1.0 + 0.1 * i;
+    As.add (i, i, g); A.set (i, i, A.get (i, i) + g);
+    if (i > 0) {
+      As.add (i, i, g); A.set (i, i, A.get (i, i) + g);
+      As.add (i - 1, i - 1, g); A.set (i - 1, i - 1, A.get (i - 1, i - 1) + g);
+      As.add (i, i - 1, -g); A.set (i, i - 1, -g);
+      As.add (i - 1, i, -g); A.set (i - 1, i, -g);
+    }
+  }
+  As.set (0, n, 1.0); A.set (0, n, 1.0);
+  As.set (n, 0, 1.0); A.set (n, 0, 1.0);
+}
+
+TEST (spmatrix, structure) {
+  qucs::spmatrix<nr_double_t> As (4);
+  As.insert (2, 1);
+  As.insert (0, 3);
+  As.compress ();
+  EXPECT_EQ (2, As.getNonZeros ());
+  EXPECT_EQ (-1, As.find (1, 2));
+  As.set (2, 1, 5.0);
+  As.insert (1, 2);
+  As.compress ();
+  EXPECT_EQ (5.0, As.get (2, 1));
+  EXPECT_EQ (0.0, As.get (1, 2));
+  As.transpose ();
+  EXPECT_EQ (5.0, As.get (1, 2));
+}
+
+TEST (eqnsys, sparseLU) {
+  const int n = 40;
+  qucs::spmatrix<nr_double_t> As (n + 1);
+  qucs::tmatrix<nr_double_t> A (n + 1);
+  qucs::tvector<nr_double_t> B (n + 1), Xs (n + 1), Xd (n + 1);
+  ladder (n, As, A);
+  B.set (n, 1.0);
+  B.set (n / 2, 0.5);
+
+  qucs::eqnsys<nr_double_t> es, ed;
+  es.setAlgo (ALGO_LU_DECOMPOSITION_SPARSE);
+  es.passEquationSys (&As, &Xs, &B);
+  es.solve ();
+  ed.setAlgo (ALGO_LU_DECOMPOSITION);
+  ed.passEquationSys (&A, &Xd, &B);
+  ed.solve ();
+  for (int i = 0; i <= n; i++)
+    EXPECT_NEAR (Xd.get (i), Xs.get (i), 1e-12);
+}
+
+TEST (eqnsys, sparseRefactor) {
+  const int n = 40;
+  qucs::spmatrix<nr_double_t> As (n + 1);
+  qucs::tmatrix<nr_double_t> A (n + 1);
+  qucs::tvector<nr_double_t> B (n + 1), Xs (n + 1), Xd (n + 1);
+  ladder (n, As, A);
+  B.set (n, 1.0);
+
+  qucs::eqnsys<nr_double_t> es, ed;
+  es.setAlgo (ALGO_LU_DECOMPOSITION_SPARSE);
+  es.setRefactor (1);
+  es.passEquationSys (&As, &Xs, &B);
+  es.solve ();
+
+  // change the values but keep the structure
+  for (int i = 0; i < n; i++) {
+    As.add (i, i, 0.5 * i);
+    A.set (i, i, A.get (i, i) + 0.5 * i);
+  }
+  es.passEquationSys (&As, &Xs, &B);
+  es.solve ();
+  ed.setAlgo (ALGO_LU_DECOMPOSITION);
+  ed.passEquationSys (&A, &Xd, &B);
+  ed.solve ();
+  for (int i = 0; i <= n; i++)
+    EXPECT_NEAR (Xd.get (i), Xs.get (i), 1e-12);
+}
+
+TEST (eqnsys, multipleRHS) {
+  const int n = 40, m = 5;
+  qucs::spmatrix<nr_double_t> As (n + 1);
+  qucs::tmatrix<nr_double_t> A (n + 1);
+  qucs::tmatrix<nr_double_t> Bm (n + 1, m), Xm (n + 1, m);
+  ladder (n, As, A);
+  for (int c = 0; c < m; c++) Bm (c * 7, c) = 1.0 + c;
+
+  qucs::tmatrix<nr_double_t> L (A);
+  qucs::eqnsys<nr_double_t> em;
+  em.setAlgo (ALGO_LU_DECOMPOSITION_CROUT);
+  em.passEquationSys (&L, NULL, NULL);
+  em.solve (&Xm, &Bm);
+  for (int c = 0; c < m; c++) {
+    qucs::tmatrix<nr_double_t> D (A);
+    qucs::tvector<nr_double_t> B = Bm.getCol (c), X (n + 1);
+    qucs::eqnsys<nr_double_t> ed;
+    ed.setAlgo (ALGO_LU_DECOMPOSITION_CROUT);
+    ed.passEquationSys (&D, &X, &B);
+    ed.solve ();
+    for (int r = 0; r <= n; r++)
+      EXPECT_NEAR (X.get (r), Xm (r, c), 1e-12);
+  }
+}
+
+TEST (eqnsys, gmres) {
+  const int n = 40;
+  qucs::spmatrix<nr_double_t> As (n + 1);
+  qucs::tmatrix<nr_double_t> A (n + 1);
+  qucs::tvector<nr_double_t> B (n + 1), Xg (n + 1), Xd (n + 1);
+  ladder (n, As, A);
+  B.set (n, 1.0);
+  B.set (n / 2, 0.5);
+
+  qucs::tmatrix<nr_double_t> G (A);
+  qucs::eqnsys<nr_double_t> eg, ed;
+  eg.setAlgo (ALGO_GMRES);
+  eg.passEquationSys (&G, &Xg, &B);
+  eg.solve ();
+  ed.setAlgo (ALGO_LU_DECOMPOSITION);
+  ed.passEquationSys (&A, &Xd, &B);
+  ed.solve ();
+  for (int i = 0; i <= n; i++)
+    EXPECT_NEAR (Xd.get (i), Xg.get (i), 1e-9);
+}
+
+/* Builds a harmonic balance like Jacobian of a ladder with diodes at
+   each node.  The harmonics are coupled by the Fourier coefficients of
+   the diode conductances, which span several decades, and the
+   capacitances grow with the frequency. */
+static void hbJacobian (int nodes, int harmonics,
+			qucs::tmatrix<nr_complex_t> & A) {
+  for (int k = 0; k < harmonics; k++) {
+    nr_double_t w = 2 * M_PI * 1e9 * k;
+    for (int i = 0; i < nodes; i++) {
+      int r = k * nodes + i;
+      nr_double_t g = std::pow (10.0, -3 + 6.0 * i / (nodes - 1));
+      A (r, r) += nr_complex_t (g, w * 1e-12);
+      if (i > 0) {
+	A (r, r) += g;
+	A (r - 1, r - 1) += g;
+	A (r, r - 1) -= g;
+	A (r - 1, r) -= g;
+      }
+      // the diode conductances couple the harmonics
+      nr_double_t gd = std::pow (10.0, -6 + 8.0 * i / (nodes - 1));
+      for (int l = 0; l < harmonics; l++)
+	A (r, l * nodes + i) += gd * std::pow (0.5, std::abs (k - l));
+    }
+  }
+}
+
+TEST (eqnsys, gmresHB) {
+  const int nodes = 8, harmonics = 16, n = nodes * harmonics;
+  qucs::tmatrix<nr_complex_t> A (n);
+  qucs::tvector<nr_complex_t> B (n), Xg (n), Xd (n);
+  hbJacobian (nodes, harmonics, A);
+  for (int k = 0; k < harmonics; k++)
+    B.set (k * nodes, nr_complex_t (1.0 / (k + 1), 0.1 * k));
+
+  qucs::tmatrix<nr_complex_t> G (A), L (A);
+  qucs::eqnsys<nr_complex_t> eg, ed;
+  eg.setAlgo (ALGO_GMRES);
+  eg.passEquationSys (&G, &Xg, &B);
+  eg.solve ();
+  ed.setAlgo (ALGO_LU_DECOMPOSITION_CROUT);
+  ed.passEquationSys (&L, &Xd, &B);
+  ed.solve ();
+
+  // GMRES did not fall back to the LU decomposition, which works in place
+  for (int r = 0; r < n; r++)
+    for (int c = 0; c < n; c++)
+      ASSERT_EQ (A (r, c), G (r, c));
+  nr_double_t err = 0, ref = 0;
+  for (int i = 0; i < n; i++) {
+    err = std::max (err, abs (Xd.get (i) - Xg.get (i)));
+    ref = std::max (ref, abs (Xd.get (i)));
+  }
+  EXPECT_LT (err, 1e-8 * ref);
+}
@@ -0,0 +1,172 @@
+/*
+ * Tape.cpp - Unit test for compiled equation tapes
+ *
+ * Copyright (C) 2026 Qucs Team
+ *
+ * This is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2, or (at your option)
+ * any later version.
+ *
+ * This software is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this package; see the file COPYING.  If not, write to
+ * the Free Software Foundation, Inc., 51 Franklin Street - Fifth Floor,
+ * Boston, MA 02110-1301, USA.
+ *
+ */
+
+#include <string.h>
+
+#include "qucs_typedefs.h"
+#include "real.h"
+#include "complex.h"
+#include "object.h"
+#include "equation.h"
+#include "tape.h"
+
+#include "gtest/gtest.h"  // Google Test
+
+using namespace qucs::eqn;
+
+#define C(c) ((constant *) (c))
+
+/* A set of equations as used by an equation defined device: branch
+   voltages and the device equations are skipped by the equation
+   solver, the local parameters are evaluated by it. */
+class eqnset {
+public:
+  eqnset () : slv (&chk) { }
+  ~eqnset () { slv.setEquations (NULL); }
+
+  node * num (nr_double_t d) {
+    constant * c = new constant (TAG_DOUBLE);
+    c->d = d;
+    c->checkee = &chk;
+    return c;
+  }
+  node * ref (const char * n) {
+    reference * r = new reference ();
+    r->n = strdup (n);
+    r->checkee = &chk;
+    return r;
+  }
+  node * app (const char * f, node * a, node * b = NULL, node * c = NULL) {
+    application * x = new application (f, c ? 3 : b ? 2 : 1);
+    a->setNext (b);
+    if (b) b->setNext (c);
+    x->args = a;
+    x->checkee = &chk;
+    return x;
+  }
+  assignment * add (const char * n, node * body, int skip) {
+    assignment * a = new assignment ();
+    a->result = strdup (n);
+    a->body = body;
+    a->checkee = &chk;
+    a->solvee = &slv;
+    a->skip = skip;
+    a->evalPossible = 1;
+    chk.appendEquation (a);
+    slv.setEquations (chk.getEquations ());
+    a->evalType ();
+    return a;
+  }
+  assignment * derive (assignment * a, const char * n, const char * v) {
+    assignment * d = (assignment *) a->differentiate ((char *) v);
+    d->rename ((char *) n);
+    d->checkee = &chk;
+    d->solvee = &slv;
+    d->skip = 1;
+    d->evalPossible = 1;
+    chk.appendEquation (d);
+    slv.setEquations (chk.getEquations ());
+    d->evalType ();
+    return d;
+  }
+
+  checker chk;
+  solver slv;
+};
+
+TEST(tape, edd) {
+  eqnset e;
+  assignment * V1 = e.add ("V1", e.num (0.0), 1);
+  e.add ("Is", e.num (1e-14), 0);
+  e.add ("N", e.num (1.5), 0);
+  e.add ("Vt", e.app ("*", e.num (0.025), e.ref ("N")), 0);
+  // diode current with a parallel resistor
+  assignment * I1 =
+    e.add ("I1", e.app ("+",
+			e.app ("*", e.ref ("Is"),
+			       e.app ("-", e.app ("limexp",
+						  e.app ("/", e.ref ("V1"),
+							 e.ref ("Vt"))),
+				      e.num (1))),
+			e.app ("/", e.ref ("V1"), e.num (1e3))), 1);
+  // junction charge, complex for voltages below 0.7
+  assignment * Q1 =
+    e.add ("Q1", e.app ("*", e.num (1e-12),
+			e.app ("sqrt", e.app ("-", e.ref ("V1"),
+					      e.num (0.7)))), 1);
+  // piecewise with a function the tape does not know
+  assignment * X1 =
+    e.add ("X1", e.app ("?:", e.app ("<", e.ref ("V1"), e.num (0.5)),
+			e.app ("^", e.ref ("V1"), e.num (2)),
+			e.app ("arcsin", e.app ("-", e.ref ("V1"),
+						e.num (0.5)))), 1);
+  // references to skipped equations are inlined
+  assignment * Y1 =
+    e.add ("Y1", e.app ("*", e.ref ("I1"), e.ref ("X1")), 1);
+  assignment * P1 =
+    e.add ("P1", e.app ("*", e.ref ("V1"), e.ref ("Is")), 1);
+  assignment * G11 = e.derive (I1, "G11", "V1");
+  assignment * C11 = e.derive (Q1, "C11", "V1");
+  assignment * D11 = e.derive (X1, "D11", "V1");
+
+  assignment * eqns[] = { I1, Q1, X1, Y1, P1, G11, C11, D11 };
+  const int n = sizeof (eqns) / sizeof (eqns[0]);
+  tape t[n];
+  for (int i = 0; i < n; i++) {
+    t[i].compile (eqns[i]);
+    ASSERT_TRUE (t[i].isCompiled ()) << eqns[i]->result;
+  }
+
+  // only equations reading local parameter results need the solver
+  EXPECT_TRUE (t[0].needsSolver ());
+  EXPECT_FALSE (t[1].needsSolver ());
+  EXPECT_TRUE (t[2].needsSolver ());
+  EXPECT_FALSE (t[4].needsSolver ());
+  EXPECT_EQ (TAG_COMPLEX, t[1].getType ());
+
+  for (nr_double_t v = -1.0; v <= 1.2; v += 0.05) {
+    C(V1->body)->d = v;
+    V1->evaluate ();
+    e.slv.evaluate ();
+    for (int i = 0; i < n; i++) {
+      eqns[i]->evaluate ();
+      nr_complex_t r = eqns[i]->getResultComplex ();
+      nr_complex_t c = t[i].evalComplex ();
+      EXPECT_EQ (std::real (r), std::real (c)) << eqns[i]->result << " at " << v;
+      EXPECT_EQ (std::imag (r), std::imag (c)) << eqns[i]->result << " at " << v;
+      EXPECT_EQ (eqns[i]->getResultDouble (), t[i].evalDouble ())
+	<< eqns[i]->result << " at " << v;
+    }
+  }
+
+  // the derivative tapes match the difference quotients
+  for (nr_double_t v = 0.1; v <= 0.65; v += 0.05) {
+    nr_double_t h = 1e-7, f[2];
+    for (int k = 0; k < 2; k++) {
+      C(V1->body)->d = v + (k ? h : -h);
+      f[k] = t[0].evalDouble ();
+    }
+    C(V1->body)->d = v;
+    nr_double_t g = t[5].evalDouble ();
+    EXPECT_NEAR (g, (f[1] - f[0]) / 2 / h, 1e-6 * std::abs (g));
+  }
+}
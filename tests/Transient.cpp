@@ -0,0 +1,100 @@
+/*
+ * Transient.cpp - Unit test for the transient solver
+ *
+ * Copyright (C) 2026 Qucs Team
+ *
+ * This is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2, or (at your option)
+ * any later version.
+ *
+ * This software is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this package; see the file COPYING.  If not, write to
+ * the Free Software Foundation, Inc., 51 Franklin Street - Fifth Floor,
+ * Boston, MA 02110-1301, USA.
+ *
+ */
+
+#include <string>
+#include <algorithm>
+
+#include "testNetlist.h"  // netlists loaded from memory
+#include "nasolver.h"
+#include "trsolver.h"
+#include "gtest/gtest.h"  // Google Test
+
+static const char * pulse =
+  "Vpulse:V1 in gnd U1=\"0 V\" U2=\"5 V\" T1=\"%s\" T2=\"%s\" "
+  "Tr=\"10 us\" Tf=\"10 us\"\n"
+  "R:R1 in a R=\"1 kOhm\" Temp=\"26.85\" Tc1=\"0.0\" Tc2=\"0.0\" "
+  "Tnom=\"26.85\"\n"
+  "C:C1 a gnd C=\"10 nF\"\n"
+  "Diode:D1 a out Is=\"1e-14\" N=\"1\" Cj0=\"1 pF\" M=\"0.5\" Vj=\"0.7\"\n"
+  "R:R2 out gnd R=\"10 kOhm\" Temp=\"26.85\" Tc1=\"0.0\" Tc2=\"0.0\" "
+  "Tnom=\"26.85\"\n"
+  ".TR:TR1 Type=\"lin\" Start=\"0\" Stop=\"1 ms\" Points=\"101\" "
+  "IntegrationMethod=\"Trapezoidal\" Order=\"2\" InitialStep=\"1 ns\" "
+  "MinStep=\"1e-16\" MaxIter=\"%d\" reltol=\"0.001\" abstol=\"1 pA\" "
+  "vntol=\"1 uV\" LTEreltol=\"1e-3\" LTEabstol=\"1e-6\" LTEfactor=\"1\" "
+  "Solver=\"CroutLU\" relaxTSR=\"no\" initialDC=\"yes\" MaxStep=\"0\" "
+  "ModifiedNewton=\"%s\"\n";
+
+// Returns the transient analysis of the given netlist.
+static qucs::trsolver * transientSolver (memnet & n) {
+  return dynamic_cast<qucs::trsolver *> (n.subnet->findAnalysis ("TR1"));
+}
+
+TEST (trsolver, breakpoints) {
+  netsetup s;
+  // pulse corners on the output time points and in between
+  memnet on (format (pulse, "120 us", "500 us", 150, "no"));
+  memnet off (format (pulse, "123.3 us", "503.3 us", 150, "no"));
+  ASSERT_TRUE (on.loaded && on.run () != NULL);
+  ASSERT_TRUE (off.loaded && off.run () != NULL);
+
+  // steps land on T1, T1 + Tr, T2 - Tf and T2
+  EXPECT_EQ (4, transientSolver (on)->getBreakpoints ());
+  EXPECT_EQ (0, transientSolver (on)->getMissed ());
+  EXPECT_EQ (4, transientSolver (off)->getBreakpoints ());
+  EXPECT_EQ (0, transientSolver (off)->getMissed ());
+
+  // corners between the output points do not cost any rejections
+  EXPECT_LE (transientSolver (off)->getRejected (),
+	     transientSolver (on)->getRejected ());
+
+  // the corners are hit after convergence failures as well
+  memnet fail (format (pulse, "123.3 us", "503.3 us", 3, "no"));
+  ASSERT_TRUE (fail.loaded && fail.run () != NULL);
+  EXPECT_EQ (4, transientSolver (fail)->getBreakpoints ());
+  EXPECT_EQ (0, transientSolver (fail)->getMissed ());
+}
+
+TEST (trsolver, modifiednewton) {
+  netsetup s;
+  memnet full (format (pulse, "123.3 us", "503.3 us", 150, "no"));
+  memnet chord (format (pulse, "123.3 us", "503.3 us", 150, "yes"));
+  ASSERT_TRUE (full.loaded && full.run () != NULL);
+  ASSERT_TRUE (chord.loaded && chord.run () != NULL);
+  EXPECT_EQ (0, transientSolver (full)->getReused ());
+  EXPECT_GT (transientSolver (chord)->getReused (), 0);
+
+  // both converge to the same waveforms within the tolerances
+  const char * vars[] = { "a.Vt", "out.Vt", "V1.It" };
+  for (int k = 0; k < 3; k++) {
+    qucs::vector v1 = full.result (vars[k]);
+    qucs::vector v2 = chord.result (vars[k]);
+    ASSERT_EQ (101, v1.getSize ()) << vars[k];
+    ASSERT_EQ (101, v2.getSize ()) << vars[k];
+    nr_double_t peak = 0;
+    for (int i = 0; i < 101; i++)
+      peak = std::max (peak, (nr_double_t) abs (v1.get (i)));
+    for (int i = 0; i < 101; i++)
+      EXPECT_NEAR (real (v1.get (i)), real (v2.get (i)), 1e-3 * peak)
+	<< vars[k] << " at " << i;
+  }
+}
@@ -0,0 +1,115 @@
+/*
+ * testNetlist.h - Helpers for the tests loading netlists from memory.
+ *
+ * Copyright (C) 2026 Qucs Team
+ *
+ * This is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2, or (at your option)
+ * any later version.
+ *
+ * This software is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this package; see the file COPYING.  If not, write to
+ * the Free Software Foundation, Inc., 51 Franklin Street - Fifth Floor,
+ * Boston, MA 02110-1301, USA.
+ *
+ */
+
+#ifndef __TESTNETLIST_H__
+#define __TESTNETLIST_H__
+
+#include <stdio.h>
+#include <stdarg.h>
+#include <string>
+
+#include "qucs_typedefs.h"
+#include "object.h"
+#include "complex.h"
+#include "vector.h"
+#include "dataset.h"
+#include "environment.h"
+#include "circuit.h"
+#include "net.h"
+#include "input.h"
+#include "analysis.h"
+#include "module.h"
+#include "logging.h"
+
+// Formats a netlist from the given template and arguments.
+inline std::string format (const char * fmt, ...) {
+  char buf[4096];
+  va_list args;
+  va_start (args, fmt);
+  vsnprintf (buf, sizeof (buf), fmt, args);
+  va_end (args);
+  return std::string (buf);
+}
+
+/* Sets up the logging and registers the component modules for the
+   lifetime of the object.  Each test loading netlists creates one
+   first. */
+class netsetup
+{
+ public:
+  netsetup () {
+    loginit ();
+    qucs::module::registerModules ();
+  }
+  ~netsetup () {
+    qucs::module::unregisterModules ();
+  }
+};
+
+/* A netlist loaded from memory.  The object owns the netlist, its
+   environment and the dataset of the last analysis run. */
+class memnet
+{
+ public:
+  memnet (const std::string & t) : text (t), out (NULL), err (0) {
+    root = new qucs::environment ("root");
+    subnet = new qucs::net ("subnet");
+    in = new qucs::input ();
+    subnet->setEnv (root);
+    in->setEnv (root);
+    in->setBuffer (text.c_str (), text.size ());
+    loaded = in->netlist (subnet) == 0;
+  }
+  ~memnet () {
+    delete out;
+    delete subnet;
+    delete root;
+    delete in;
+  }
+  // runs all analyses, or the given one only, and returns the dataset
+  qucs::dataset * run (const char * name = NULL) {
+    delete out;
+    out = name ? subnet->runAnalysis (name, err) : subnet->runAnalysis (err);
+    if (out != NULL) root->equationSolver (out);
+    return out;
+  }
+  // returns the given result vector, empty if there is no such
+  qucs::vector result (const char * var) {
+    qucs::vector * v = out ? out->findVariable (var) : NULL;
+    return v ? *v : qucs::vector ();
+  }
+  // returns the first value of the given result, -1 if there is no such
+  nr_double_t value (const char * var) {
+    qucs::vector v = result (var);
+    return v.getSize () > 0 ? real (v.get (0)) : -1;
+  }
+
+  std::string text;
+  qucs::environment * root;
+  qucs::net * subnet;
+  qucs::input * in;
+  qucs::dataset * out;
+  bool loaded;
+  int err;
+};
+
+#endif /* __TESTNETLIST_H__ */